@@ -0,0 +1,276 @@
+// Timings of the soft body hot paths on every bundled model.
+//
+//   physics_bench [--models DIR] [--json FILE] [--samples N] [--threads N]
+//
+// Every operation is run in batches until a batch takes at least ~10 ms, and
+// the median batch of `samples` is reported per call, per vertex (particle)
+// and, where it applies, per constraint. With --json the same numbers are
+// written as a JSON document for tracking regressions between versions.
+//
+// Models are copied to a temporary directory first, so the mesh caches the
+// loads write never land next to the bundled models.
+
+#include "core/components/softbody.h"
+#include "core/assets/mesh_data.h"
+#include "core/assets/welded_mesh.h"
+#include "core/job_system.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    struct Result {
+        std::string model;
+        std::string operation;
+        size_t vertices;
+        size_t constraints;
+        double nsPerCall;
+    };
+
+    // Time of `batch` calls to fn, in nanoseconds. With a reset, the calls
+    // run in windows of at most `window`, each after an untimed reset.
+    double TimeBatch(const std::function<void()>& fn, size_t batch,
+                     const std::function<void()>& reset, size_t window) {
+        double total = 0.0;
+        for (size_t done = 0; done < batch;) {
+            if (reset) reset();
+
+            const size_t count = std::min(window, batch - done);
+            const auto start = Clock::now();
+            for (size_t i = 0; i < count; ++i) fn();
+            const std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+
+            total += elapsed.count();
+            done += count;
+        }
+        return total;
+    }
+
+    // Median time of one call to fn, in nanoseconds. Operations that change
+    // the state they run on pass a reset back to a known state, and a window
+    // short enough that the state stays close to it.
+    double Measure(const std::function<void()>& fn, int samples,
+                   const std::function<void()>& reset = nullptr, size_t window = SIZE_MAX) {
+        // Warm up and find a batch size worth timing
+        size_t batch = 1;
+        for (;;) {
+            const double elapsed = TimeBatch(fn, batch, reset, window);
+            if (elapsed >= 1e7 || batch >= (1u << 20)) break;
+            batch *= 2;
+        }
+
+        std::vector<double> times;
+        for (int s = 0; s < samples; ++s) {
+            times.push_back(TimeBatch(fn, batch, reset, window) / static_cast<double>(batch));
+        }
+
+        std::nth_element(times.begin(), times.begin() + times.size() / 2, times.end());
+        return times[times.size() / 2];
+    }
+
+    // Same substep parameters the editor runs with (60 Hz, 8 substeps)
+    constexpr int kSubsteps = 8;
+    constexpr float kSubstep = 1.0f / 60.0f / kSubsteps;
+    const glm::vec3 kGravity(0.0f, -9.81f, 0.0f);
+
+    // The simulation operations start from a body this many frames into the
+    // editor's simulation, falling onto or resting on the floor
+    constexpr int kSettleFrames = 30;
+
+    // `path` is the model's copy in the temporary directory
+    void BenchModel(const std::string& path, int samples, JobSystem& jobs, std::vector<Result>& results) {
+        const std::string model = std::filesystem::path(path).stem().string();
+        const std::string cachePath = MeshData::CachePath(path);
+
+        // Loads and builds log as they go; keep that out of the table
+        std::streambuf* log = std::cout.rdbuf(nullptr);
+
+        std::shared_ptr<const MeshData> mesh = MeshData::Load(path);
+        const WeldedMesh welded = WeldedMesh::Build(*mesh);
+        std::shared_ptr<const SoftBodyTopology> topology = SoftBodyTopology::Build(path, welded);
+        const size_t vertices = topology->GetParticleCount();
+        const size_t constraints = topology->constraints.size();
+
+        auto add = [&](const char* operation, double ns) {
+            results.push_back({model, operation, vertices, constraints, ns});
+        };
+
+        // Loading: a first start parses the OBJ and writes its cache, every
+        // later start maps the cache. Then the weld and topology build a first
+        // SoftBody of the model pays, and the per instance cost of every
+        // further body.
+        const int loadSamples = std::max(1, samples / 4);
+        add("LoadMeshParse", Measure([&] { MeshData::Load(path); }, loadSamples,
+                                     [&] { std::filesystem::remove(cachePath); }, 1));
+        MeshData::Load(path);
+        add("LoadMeshCached", Measure([&] { MeshData::Load(path); }, samples));
+        add("BuildTopology", Measure([&] { SoftBodyTopology::Build(path, WeldedMesh::Build(*mesh)); }, loadSamples));
+        add("Construct", Measure([&] { SoftBody body(topology); }, samples));
+
+        std::cout.rdbuf(log);
+
+        SoftBody start(topology);
+        for (int step = 0; step < kSettleFrames * kSubsteps; ++step) {
+            start.Substep(kSubstep, kGravity);
+        }
+
+        // Every window is at most one frame of substeps from `start`, so no
+        // operation runs on a body that has fallen through the floor or been
+        // flattened onto it
+        SoftBody body(start);
+        const auto reset = [&] {
+            body.particles = start.particles;
+            body.lambdas = start.lambdas;
+        };
+        auto measure = [&](const std::function<void()>& fn) {
+            return Measure(fn, samples, reset, kSubsteps);
+        };
+
+        add("Integrate", measure([&] { body.Integrate(kSubstep, kGravity); }));
+        add("SolveFloorCollision", measure([&] { body.SolveFloorCollision(0.0f); }));
+
+        body.solverMode = SolverMode::GaussSeidel;
+        add("SolveConstraints", measure([&] { body.SolveConstraints(kSubstep, 1); }));
+        if (!jobs.IsSingleThreaded()) {
+            add("SolveConstraintsParallel", measure([&] { body.SolveConstraints(kSubstep, 1, &jobs); }));
+        }
+
+        body.solverMode = SolverMode::Jacobi;
+        add("SolveConstraintsJacobi", measure([&] { body.SolveConstraints(kSubstep, 1); }));
+
+        body.solverMode = SolverMode::GaussSeidel;
+        add("Substep", measure([&] { body.Substep(kSubstep, kGravity); }));
+    }
+
+    void PrintTable(const std::vector<Result>& results) {
+        std::cout << std::left << std::setw(10) << "model"
+                  << std::setw(26) << "operation"
+                  << std::right << std::setw(9) << "vertices"
+                  << std::setw(12) << "constraints"
+                  << std::setw(14) << "ns/call"
+                  << std::setw(12) << "ns/vertex"
+                  << std::setw(16) << "ns/constraint" << std::endl;
+
+        std::cout << std::fixed << std::setprecision(2);
+        for (const Result& r : results) {
+            std::cout << std::left << std::setw(10) << r.model
+                      << std::setw(26) << r.operation
+                      << std::right << std::setw(9) << r.vertices
+                      << std::setw(12) << r.constraints
+                      << std::setw(14) << r.nsPerCall
+                      << std::setw(12) << r.nsPerCall / std::max<size_t>(1, r.vertices)
+                      << std::setw(16) << r.nsPerCall / std::max<size_t>(1, r.constraints) << std::endl;
+        }
+    }
+
+    bool WriteJson(const std::string& path, const std::vector<Result>& results, const JobSystem& jobs) {
+        std::ofstream out(path);
+        if (!out) {
+            std::cerr << "Could not write " << path << std::endl;
+            return false;
+        }
+
+        out << std::setprecision(6);
+        out << "{\n";
+        out << "  \"instructionSet\": \"" << simd::ActiveInstructionSet() << "\",\n";
+        out << "  \"threads\": " << jobs.GetThreadCount() << ",\n";
+        out << "  \"results\": [\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            out << "    {\"model\": \"" << r.model << "\""
+                << ", \"operation\": \"" << r.operation << "\""
+                << ", \"vertices\": " << r.vertices
+                << ", \"constraints\": " << r.constraints
+                << ", \"nsPerCall\": " << r.nsPerCall
+                << ", \"nsPerVertex\": " << r.nsPerCall / std::max<size_t>(1, r.vertices)
+                << ", \"nsPerConstraint\": " << r.nsPerCall / std::max<size_t>(1, r.constraints)
+                << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n";
+        out << "}\n";
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string modelDir = "../resources/models/";
+    std::string jsonPath;
+    int samples = 15;
+    size_t threadCount = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "--models" && hasValue) {
+            modelDir = argv[++i];
+        }
+        else if (arg == "--json" && hasValue) {
+            jsonPath = argv[++i];
+        }
+        else if (arg == "--samples" && hasValue) {
+            samples = std::max(1, std::stoi(argv[++i]));
+        }
+        else if (arg == "--threads" && hasValue) {
+            threadCount = std::stoul(argv[++i]);
+        }
+        else {
+            std::cerr << "usage: physics_bench [--models DIR] [--json FILE] [--samples N] [--threads N]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<std::string> models;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(modelDir, error)) {
+        if (entry.path().extension() == ".obj") {
+            models.push_back(entry.path().string());
+        }
+    }
+    if (error || models.empty()) {
+        std::cerr << "No .obj models found in " << modelDir << std::endl;
+        return 1;
+    }
+    std::sort(models.begin(), models.end());
+
+    const std::filesystem::path workDir = std::filesystem::temp_directory_path(error) / "physics_bench";
+    std::filesystem::create_directories(workDir, error);
+    for (std::string& model : models) {
+        if (error) break;
+        const std::filesystem::path copy = workDir / std::filesystem::path(model).filename();
+        std::filesystem::copy_file(model, copy, std::filesystem::copy_options::overwrite_existing, error);
+        model = copy.string();
+    }
+    if (error) {
+        std::cerr << "Could not copy the models to " << workDir.string() << ": " << error.message() << std::endl;
+        return 1;
+    }
+
+    JobSystem jobs(threadCount);
+
+    std::vector<Result> results;
+    for (const std::string& model : models) {
+        BenchModel(model, samples, jobs, results);
+    }
+    std::filesystem::remove_all(workDir, error);
+
+    std::cout << "instruction set: " << simd::ActiveInstructionSet()
+              << ", threads: " << jobs.GetThreadCount() << std::endl;
+    PrintTable(results);
+
+    if (!jsonPath.empty() && !WriteJson(jsonPath, results, jobs)) {
+        return 1;
+    }
+
+    return 0;
+}
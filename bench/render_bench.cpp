@@ -0,0 +1,185 @@
+// Timings of the renderer's CPU side draw list, without a GL context.
+//
+//   render_bench [--items N] [--meshes N] [--materials N] [--samples N]
+//
+// Builds a synthetic frame of `items` objects spread over `meshes` meshes and
+// `materials` materials (1% soft bodies), each drawn in the shadow and the
+// main pass, like RenderEngine::BuildDrawList does. Reports the median time
+// of culling, gathering, sorting and submitting it, and how many GL calls
+// the submission would have issued.
+
+#include "core/physics/simd_kernels.h"
+#include "render/draw_list.h"
+#include "render/frustum.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    // Median time of one call to fn, in nanoseconds
+    double Measure(const std::function<void()>& fn, int samples) {
+        // Warm up and find a batch size worth timing
+        size_t batch = 1;
+        for (;;) {
+            const auto start = Clock::now();
+            for (size_t i = 0; i < batch; ++i) fn();
+            const std::chrono::duration<double> elapsed = Clock::now() - start;
+            if (elapsed.count() >= 0.01 || batch >= (1u << 20)) break;
+            batch *= 2;
+        }
+
+        std::vector<double> times;
+        for (int s = 0; s < samples; ++s) {
+            const auto start = Clock::now();
+            for (size_t i = 0; i < batch; ++i) fn();
+            const std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+            times.push_back(elapsed.count() / static_cast<double>(batch));
+        }
+
+        std::nth_element(times.begin(), times.begin() + times.size() / 2, times.end());
+        return times[times.size() / 2];
+    }
+
+    // Counts what RenderEngine's backend would turn into GL calls
+    struct CountingBackend {
+        size_t programBinds = 0;
+        size_t meshBinds = 0;
+        size_t materialBinds = 0;
+        size_t draws = 0;
+        size_t instances = 0;
+
+        void BindProgram(uint32_t) { ++programBinds; }
+        void BindMesh(uint32_t) { ++meshBinds; }
+        void BindMaterial(uint32_t) { ++materialBinds; }
+        void Draw(size_t, size_t count) { ++draws; instances += count; }
+    };
+
+    struct Object {
+        uint32_t mesh;
+        uint32_t material;
+        bool softBody;
+    };
+
+    void Gather(DrawList& list, const std::vector<Object>& objects) {
+        list.Clear();
+        list.Reserve(2 * objects.size());
+
+        uint32_t softBodyCount = 0;
+        for (size_t i = 0; i < objects.size(); ++i) {
+            const Object& object = objects[i];
+            const uint32_t unique = object.softBody ? ++softBodyCount : 0;
+            list.Add(DrawKey::Make(RenderPass::Shadow, 1, object.mesh, 0, unique), static_cast<uint32_t>(i));
+            list.Add(DrawKey::Make(RenderPass::Main, 0, object.mesh, object.material, unique), static_cast<uint32_t>(i));
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t itemCount = 100000;
+    uint32_t meshCount = 64;
+    uint32_t materialCount = 16;
+    int samples = 15;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "--items" && hasValue) {
+            itemCount = std::stoul(argv[++i]);
+        }
+        else if (arg == "--meshes" && hasValue) {
+            meshCount = static_cast<uint32_t>(std::max(1ul, std::stoul(argv[++i])));
+        }
+        else if (arg == "--materials" && hasValue) {
+            materialCount = static_cast<uint32_t>(std::max(1ul, std::stoul(argv[++i])));
+        }
+        else if (arg == "--samples" && hasValue) {
+            samples = std::max(1, std::stoi(argv[++i]));
+        }
+        else {
+            std::cerr << "usage: render_bench [--items N] [--meshes N] [--materials N] [--samples N]" << std::endl;
+            return 1;
+        }
+    }
+
+    // Scene order is unrelated to mesh and material, as in the editor
+    std::mt19937 rng(1234);
+    std::vector<Object> objects(itemCount);
+    for (Object& object : objects) {
+        object.mesh = rng() % meshCount;
+        object.material = rng() % materialCount;
+        object.softBody = rng() % 100 == 0;
+    }
+
+    // Objects scattered over a 400 m square, seen from above one edge
+    AabbList bounds;
+    std::uniform_real_distribution<float> position(-200.0f, 200.0f);
+    for (size_t i = 0; i < objects.size(); ++i) {
+        const glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(position(rng), 0.0f, position(rng)));
+        bounds.Add(glm::vec3(-1.0f), glm::vec3(1.0f), model);
+    }
+    const glm::mat4 camera = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f)
+                           * glm::lookAt(glm::vec3(0.0f, 10.0f, 200.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    const Frustum frustum = Frustum::FromMatrix(camera);
+
+    std::vector<uint8_t> visible;
+    const double cullNs = Measure([&] { CullAabbs(frustum, bounds, visible); }, samples);
+    size_t visibleCount = 0;
+    for (uint8_t v : visible) visibleCount += v;
+
+    DrawList list;
+    const double gatherNs = Measure([&] { Gather(list, objects); }, samples);
+    const double gatherSortNs = Measure([&] { Gather(list, objects); list.Sort(); }, samples);
+
+    // Submit both passes of the sorted frame
+    CountingBackend counts;
+    const double submitNs = Measure([&] {
+        CountingBackend backend;
+        list.Submit(RenderPass::Shadow, backend);
+        list.Submit(RenderPass::Main, backend);
+        counts = backend;
+    }, samples);
+
+    const auto& items = list.GetItems();
+    if (!std::is_sorted(items.begin(), items.end(), [](const DrawItem& a, const DrawItem& b) { return a.key < b.key; })) {
+        std::cerr << "Draw list is not sorted" << std::endl;
+        return 1;
+    }
+
+    const double perItem = 1.0 / std::max<size_t>(1, list.Size());
+    std::cout << "instruction set: " << simd::ActiveInstructionSet()
+              << ", objects: " << objects.size() << " (" << visibleCount << " in the frustum)"
+              << ", draw items: " << list.Size()
+              << ", meshes: " << meshCount << ", materials: " << materialCount << std::endl;
+
+    // Cull is per object, the other stages per draw item
+    std::cout << std::left << std::setw(12) << "stage"
+              << std::right << std::setw(14) << "ns/frame"
+              << std::setw(12) << "ns/item" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << std::left << std::setw(12) << "Cull" << std::right << std::setw(14) << cullNs
+              << std::setw(12) << cullNs / std::max<size_t>(1, objects.size()) << std::endl;
+    std::cout << std::left << std::setw(12) << "Gather" << std::right << std::setw(14) << gatherNs
+              << std::setw(12) << gatherNs * perItem << std::endl;
+    std::cout << std::left << std::setw(12) << "Sort" << std::right << std::setw(14) << gatherSortNs - gatherNs
+              << std::setw(12) << (gatherSortNs - gatherNs) * perItem << std::endl;
+    std::cout << std::left << std::setw(12) << "Submit" << std::right << std::setw(14) << submitNs
+              << std::setw(12) << submitNs * perItem << std::endl;
+
+    std::cout << "draws: " << counts.draws << " (" << counts.instances << " instances)"
+              << ", program binds: " << counts.programBinds
+              << ", mesh binds: " << counts.meshBinds
+              << ", material binds: " << counts.materialBinds << std::endl;
+
+    return 0;
+}
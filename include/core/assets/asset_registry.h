@@ -0,0 +1,97 @@
+#pragma once
+
+#include "mesh_data.h"
+#include "mesh_handle.h"
+#include "welded_mesh.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class JobSystem;
+struct SoftBodyTopology;
+
+enum class AssetState {
+    Unloaded,
+    Loading,   // queued or parsing on a background job
+    Ready,
+    Failed     // the OBJ could not be loaded; RequestMesh will not retry
+};
+
+// Loads every mesh once and shares it between the renderer and the physics.
+// Each mesh has three views, all built from the same MeshData:
+//   render   - MeshData, one vertex per position/normal/texcoord combination
+//   welded   - WeldedMesh, positions welded for the simulation, with the
+//              render -> welded vertex remap
+//   topology - SoftBodyTopology (constraints, coloring) over the welded mesh
+// The welded and topology views are only built when a soft body needs them.
+// All functions are safe to call from several threads.
+class AssetRegistry {
+public:
+    // The registry every part of the engine loads through
+    static AssetRegistry& Instance();
+
+    // Returns the handle of the mesh, loading it first if needed (parsed on
+    // `jobs` when given). Throws std::runtime_error if the OBJ cannot be loaded.
+    MeshHandle LoadMesh(const std::string& path, JobSystem* jobs = nullptr);
+
+    // Returns immediately; the mesh is loaded by a background job on `jobs`
+    // unless it is already loading or loaded. Poll GetMeshState for Ready.
+    MeshHandle RequestMesh(const std::string& path, JobSystem& jobs);
+
+    // kInvalidMesh if the mesh was never requested or loaded
+    MeshHandle FindMesh(const std::string& path) const;
+
+    AssetState GetMeshState(MeshHandle handle) const;
+
+    const std::string& GetPath(MeshHandle handle) const;
+    const MeshData& GetRenderMesh(MeshHandle handle) const;
+    const WeldedMesh& GetWeldedMesh(MeshHandle handle);
+    std::shared_ptr<const SoftBodyTopology> GetTopology(MeshHandle handle);
+
+    size_t GetMeshCount() const;
+
+private:
+    struct MeshEntry {
+        std::string path;
+
+        // What GetMeshState reports: Loading from the moment RequestMesh
+        // queues the load
+        std::atomic<AssetState> state{AssetState::Unloaded};
+
+        // Guards the view states. A view is built outside the lock by the
+        // thread that set it Loading; other callers wait on `built`.
+        std::mutex mutex;
+        std::condition_variable built;
+
+        AssetState renderState = AssetState::Unloaded;
+        std::shared_ptr<const MeshData> render;
+
+        AssetState weldedState = AssetState::Unloaded;
+        WeldedMesh welded;
+
+        AssetState topologyState = AssetState::Unloaded;
+        std::shared_ptr<const SoftBodyTopology> topology;
+    };
+
+    MeshEntry& Entry(MeshHandle handle) const;
+
+    // Runs build for a view of the entry unless the view is Ready. A build
+    // that throws leaves the view Failed and rethrows; the next caller, or
+    // one that was waiting, builds it again.
+    template <typename Build>
+    static void BuildView(MeshEntry& entry, AssetState& state, Build&& build);
+
+    // Finds or adds the entry for a path
+    MeshHandle Register(const std::string& path, MeshEntry*& entry);
+
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, MeshHandle> handles;
+
+    // unique_ptr keeps entries in place while the table grows
+    std::vector<std::unique_ptr<MeshEntry>> meshes;
+};
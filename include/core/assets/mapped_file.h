@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Read only memory mapping of a whole file (CreateFileMapping on Windows,
+// mmap elsewhere). The bytes stay valid until Close() or destruction.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // Returns false if the file does not exist or cannot be mapped
+    bool Open(const std::string& path);
+    void Close();
+
+    bool IsOpen() const { return open; }
+
+    // Null for an empty file
+    const uint8_t* Data() const { return data; }
+    size_t Size() const { return size; }
+
+private:
+    void Swap(MappedFile& other) noexcept;
+
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    bool open = false;
+
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#else
+    int fd = -1;
+#endif
+};
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "mapped_file.h"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class JobSystem;
+
+// Layout of a .meshcache file, written next to the OBJ it was built from.
+// All sections are 16 byte aligned, values are little endian.
+//   Header | positions (vec3) | normals (vec3) | texcoords (vec2) | indices (u16 or u32)
+struct MeshCacheHeader {
+    static constexpr uint32_t kMagic = 0x434d4550; // "PEMC"
+    static constexpr uint32_t kVersion = 1;
+
+    uint32_t magic;
+    uint32_t version;
+
+    // The OBJ this cache was built from. Size and time are checked first;
+    // only when they differ is the OBJ hashed and compared.
+    uint64_t sourceSize;
+    int64_t sourceTime;
+    uint64_t sourceHash;
+
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t indexSize;   // 2 or 4 bytes
+    uint32_t reserved;
+
+    uint64_t positionsOffset;
+    uint64_t normalsOffset;
+    uint64_t texCoordsOffset;
+    uint64_t indicesOffset;
+    uint64_t fileSize;
+};
+
+// Triangle mesh as the renderer wants it: one vertex per unique
+// (position, normal, texcoord) combination of the OBJ, and a triangle list.
+// The arrays point straight into the mapped cache file (or, right after a
+// rebuild, into the image that was written to it); nothing is copied.
+class MeshData {
+public:
+    // Maps <objPath>.meshcache, rebuilding it from the OBJ first if it is
+    // missing, stale or from another format version (parsed on `jobs` when
+    // given). Throws std::runtime_error if the OBJ cannot be loaded.
+    static std::shared_ptr<const MeshData> Load(const std::string& objPath, JobSystem* jobs = nullptr);
+
+    // Cache file used for an OBJ
+    static std::string CachePath(const std::string& objPath);
+
+    size_t GetVertexCount() const { return header->vertexCount; }
+    size_t GetIndexCount() const { return header->indexCount; }
+
+    const glm::vec3* GetPositions() const { return Section<glm::vec3>(header->positionsOffset); }
+    const glm::vec3* GetNormals() const { return Section<glm::vec3>(header->normalsOffset); }
+    const glm::vec2* GetTexCoords() const { return Section<glm::vec2>(header->texCoordsOffset); }
+
+    // Raw index buffer; 16 bit when every vertex index fits, 32 bit otherwise
+    size_t GetIndexSize() const { return header->indexSize; }
+    const void* GetIndexData() const { return bytes + header->indicesOffset; }
+
+    uint32_t GetIndex(size_t i) const {
+        return header->indexSize == 2 ? Section<uint16_t>(header->indicesOffset)[i]
+                                      : Section<uint32_t>(header->indicesOffset)[i];
+    }
+
+    // Axis aligned bounds of the positions, in model space
+    const glm::vec3& GetBoundsMin() const { return boundsMin; }
+    const glm::vec3& GetBoundsMax() const { return boundsMax; }
+
+    // True if Load found an up to date cache instead of parsing the OBJ
+    bool FromCache() const { return mapping.IsOpen(); }
+
+private:
+    void ComputeBounds();
+
+    template <typename T>
+    const T* Section(uint64_t offset) const {
+        return reinterpret_cast<const T*>(bytes + offset);
+    }
+
+    // Exactly one of these holds the file image
+    MappedFile mapping;
+    std::vector<uint8_t> image;
+
+    const uint8_t* bytes = nullptr;
+    const MeshCacheHeader* header = nullptr;
+
+    glm::vec3 boundsMin = glm::vec3(0.0f);
+    glm::vec3 boundsMax = glm::vec3(0.0f);
+};
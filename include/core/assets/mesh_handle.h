@@ -0,0 +1,7 @@
+#pragma once
+
+#include <cstdint>
+
+// Index of a mesh in the AssetRegistry; stays valid for the whole run
+using MeshHandle = uint32_t;
+constexpr MeshHandle kInvalidMesh = UINT32_MAX;
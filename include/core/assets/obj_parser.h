@@ -0,0 +1,21 @@
+#pragma once
+
+#include "render/tiny_obj_loader.h"
+#include <string>
+#include <vector>
+
+class JobSystem;
+
+// Reads an OBJ into the same (triangulated) attrib_t / shape_t layout
+// tinyobj::LoadObj produces. The file is memory mapped and split into line
+// aligned chunks that are parsed in parallel on `jobs` (on the calling thread
+// when null), then merged in file order.
+//
+// Only geometry is read: mtllib / usemtl are skipped, so every material id
+// is -1. Returns false and sets `err` if the file cannot be read.
+bool ParseObj(
+    const std::string& path,
+    tinyobj::attrib_t& attrib,
+    std::vector<tinyobj::shape_t>& shapes,
+    std::string& err,
+    JobSystem* jobs = nullptr);
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+class MeshData;
+
+// Physics view of a mesh. The render mesh splits a position wherever normals
+// or texcoords differ; here those copies are welded back into one vertex so
+// the surface is a single connected piece of cloth.
+struct WeldedMesh {
+    // One entry per distinct position, in order of first use by the triangles
+    std::vector<glm::vec3> positions;
+
+    // Triangle list over `positions`
+    std::vector<uint32_t> indices;
+
+    // weldedOfRenderVertex[renderVertex] = welded vertex with the same position
+    std::vector<uint32_t> weldedOfRenderVertex;
+
+    size_t GetVertexCount() const { return positions.size(); }
+
+    static WeldedMesh Build(const MeshData& mesh);
+};
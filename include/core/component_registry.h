@@ -0,0 +1,215 @@
+#pragma once
+
+#include "components/component.h"
+#include "components/transform.h"
+#include "components/material.h"
+#include "components/model.h"
+#include "components/light.h"
+#include "components/softbody.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+class GameObject;
+
+// Index of a game object in its scene's component pools
+using Entity = uint32_t;
+
+// Bit `type` set for every COMPONENT_TYPE an entity has
+using ComponentMask = uint32_t;
+
+constexpr ComponentMask MaskOf(COMPONENT_TYPE type) { return ComponentMask(1) << type; }
+
+// Sparse set of one component type: `sparse` maps an entity to its slot in
+// the dense arrays. The pool owns the components and keeps them back to back,
+// so walking a pool reads contiguous memory. Removal moves the last component
+// into the hole, so the dense arrays never have gaps. Pointers into a pool
+// stay valid until the next Insert or Erase on it.
+template <typename T>
+class ComponentPool {
+public:
+    bool Contains(Entity entity) const {
+        return entity < sparse.size() && sparse[entity] != kNone;
+    }
+
+    T* Get(Entity entity) {
+        return Contains(entity) ? &components[sparse[entity]] : nullptr;
+    }
+
+    const T* Get(Entity entity) const {
+        return Contains(entity) ? &components[sparse[entity]] : nullptr;
+    }
+
+    // Adds the entity's component, or replaces it
+    T& Insert(Entity entity, T component) {
+        if (entity >= sparse.size()) {
+            sparse.resize(entity + 1, kNone);
+        }
+        if (sparse[entity] != kNone) {
+            return components[sparse[entity]] = std::move(component);
+        }
+        sparse[entity] = static_cast<uint32_t>(entities.size());
+        entities.push_back(entity);
+        components.push_back(std::move(component));
+        return components.back();
+    }
+
+    void Erase(Entity entity) {
+        if (!Contains(entity)) return;
+
+        const uint32_t slot = sparse[entity];
+        const Entity last = entities.back();
+        if (slot != entities.size() - 1) {
+            entities[slot] = last;
+            components[slot] = std::move(components.back());
+        }
+        sparse[last] = slot;
+
+        entities.pop_back();
+        components.pop_back();
+        sparse[entity] = kNone;
+    }
+
+    size_t Size() const { return entities.size(); }
+
+    // Dense arrays; component i belongs to entity i
+    const std::vector<Entity>& Entities() const { return entities; }
+    std::vector<T>& Components() { return components; }
+    const std::vector<T>& Components() const { return components; }
+
+private:
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    std::vector<uint32_t> sparse;
+    std::vector<Entity> entities;
+    std::vector<T> components;
+};
+
+// One pool per component type, owned by a Scene: every component of every
+// object in the scene lives here, and a GameObject reaches its own through
+// its entity. Systems walk the pools instead of the objects: no
+// dynamic_cast, no shared_ptr copies and no pointer chasing per frame.
+class ComponentRegistry {
+public:
+    ComponentRegistry() = default;
+    ComponentRegistry(const ComponentRegistry&) = delete;
+    ComponentRegistry& operator=(const ComponentRegistry&) = delete;
+
+    // Detaches the objects that are still registered
+    ~ComponentRegistry();
+
+    // Registers the object; it has no components yet
+    void Add(GameObject& object);
+    // Unregisters the object and destroys its components
+    void Remove(GameObject& object);
+
+    // nullptr if the entity is not registered
+    GameObject* GetObject(Entity entity) const {
+        return entity < objects.size() ? objects[entity] : nullptr;
+    }
+
+    // One past the highest entity ever registered
+    size_t GetEntityCount() const { return objects.size(); }
+
+    // Which components the entity has; 0 if it is not registered
+    ComponentMask GetMask(Entity entity) const {
+        return entity < masks.size() ? masks[entity] : 0;
+    }
+
+    // Dense entity array of the pool for `type`
+    const std::vector<Entity>& GetEntities(COMPONENT_TYPE type) const;
+
+    template <typename T>
+    ComponentPool<T>& Pool() { return std::get<ComponentPool<T>>(pools); }
+
+    template <typename T>
+    const ComponentPool<T>& Pool() const { return std::get<ComponentPool<T>>(pools); }
+
+    // Adds the entity's component of type T, or replaces it
+    template <typename T>
+    T& SetComponent(Entity entity, T component) {
+        if (entity < masks.size()) masks[entity] |= MaskOf(T::kType);
+        return Pool<T>().Insert(entity, std::move(component));
+    }
+
+    // Same, for a component only known by its base class; it is moved from
+    void SetComponent(Entity entity, Component&& component);
+
+    // nullptr if the entity has no component of the type
+    Component* GetComponent(Entity entity, COMPONENT_TYPE type);
+
+    void RemoveComponent(Entity entity, COMPONENT_TYPE type);
+
+    // Entities that lost their SoftBody since the last call, so caches kept
+    // per entity (the renderer's position buffers) can drop them right away
+    std::vector<Entity> TakeRemovedSoftBodies() { return std::exchange(removedSoftBodies, {}); }
+
+    // Calls fn(Entity, Ts&...) for every entity that has all of Ts, walking
+    // the smallest of the pools, e.g.
+    //   registry.Each<Transform, Model>([](Entity e, Transform& t, Model& m) {...});
+    // fn may not add or remove components.
+    template <typename... Ts, typename Fn>
+    void Each(Fn&& fn) { EachIn<Ts...>(*this, fn); }
+
+    // Same, with const components
+    template <typename... Ts, typename Fn>
+    void Each(Fn&& fn) const { EachIn<Ts...>(*this, fn); }
+
+    // Calls fn(Entity) for every entity that has all the components in
+    // `mask` (non-zero), walking the smallest of their pools
+    template <typename Fn>
+    void EachWithMask(ComponentMask mask, Fn&& fn) const;
+
+private:
+    template <typename... Ts, typename Registry, typename Fn>
+    static void EachIn(Registry& registry, Fn& fn);
+
+    std::tuple<ComponentPool<Transform>,
+               ComponentPool<Material>,
+               ComponentPool<Model>,
+               ComponentPool<PointLight>,
+               ComponentPool<SoftBody>> pools;
+
+    // Registered objects and their component masks, by entity
+    std::vector<GameObject*> objects;
+    std::vector<ComponentMask> masks;
+
+    std::vector<Entity> removedSoftBodies;
+};
+
+template <typename... Ts, typename Registry, typename Fn>
+void ComponentRegistry::EachIn(Registry& registry, Fn& fn) {
+    const std::vector<Entity>* smallest = nullptr;
+    ((smallest = !smallest || registry.template Pool<Ts>().Size() < smallest->size()
+        ? &registry.template Pool<Ts>().Entities() : smallest), ...);
+
+    // Walk by index: fn may not add or remove components
+    const std::vector<Entity>& entities = *smallest;
+    for (size_t i = 0; i < entities.size(); ++i) {
+        const Entity entity = entities[i];
+        if ((registry.template Pool<Ts>().Contains(entity) && ...)) {
+            fn(entity, *registry.template Pool<Ts>().Get(entity)...);
+        }
+    }
+}
+
+template <typename Fn>
+void ComponentRegistry::EachWithMask(ComponentMask mask, Fn&& fn) const {
+    const std::vector<Entity>* smallest = nullptr;
+    for (size_t type = 0; type < NUM_ENUM; ++type) {
+        if (!(mask & MaskOf(static_cast<COMPONENT_TYPE>(type)))) continue;
+
+        const std::vector<Entity>& entities = GetEntities(static_cast<COMPONENT_TYPE>(type));
+        if (!smallest || entities.size() < smallest->size()) smallest = &entities;
+    }
+    if (!smallest) return;
+
+    const std::vector<Entity>& entities = *smallest;
+    for (size_t i = 0; i < entities.size(); ++i) {
+        if ((masks[entities[i]] & mask) == mask) fn(entities[i]);
+    }
+}
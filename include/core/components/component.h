@@ -11,6 +11,8 @@ enum COMPONENT_TYPE {
     NUM_ENUM
 };
 
+// Every component class also declares `static constexpr COMPONENT_TYPE kType`,
+// which picks its pool in the ComponentRegistry, for GameObject::GetComponent<T>()
 class Component {
 private:
 
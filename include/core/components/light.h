@@ -4,6 +4,8 @@
 
 class PointLight: public Component {
 public:
+    static constexpr COMPONENT_TYPE kType = LIGHT;
+
     glm::vec3 color;
     float intensity;
     PointLight(const glm::vec3 color = {1.0f, 1.0f, 1.0f} , float intensity = 1.0f)
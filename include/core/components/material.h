@@ -5,6 +5,7 @@
 
 class Material: public Component {
 public:
+    static constexpr COMPONENT_TYPE kType = MATERIAL;
 
     glm::vec3 ambient;
     glm::vec3 diffuse;
@@ -3,14 +3,21 @@
 #include <iostream>
 #include <glm/vec3.hpp>
 #include "component.h"
+#include "core/assets/mesh_handle.h"
 #include <string>
 
 #define RESOURCES_PATH "../resources/models/"
 class Model: public Component {
 public:
-    std::string modelPath;
+    static constexpr COMPONENT_TYPE kType = MODEL;
+
     std::string resourcesPath = std::string(RESOURCES_PATH);
 
+    // Mesh of the model path in the AssetRegistry, looked up by the renderer
+    // on the first draw so later frames don't hash the path. Reset whenever
+    // the path changes.
+    MeshHandle mesh = kInvalidMesh;
+
     // TODO Remove hardcoded bunny
     Model(const std::string& _modelPath = "cube.obj")
     {
@@ -20,10 +27,22 @@ public:
         std::cout << modelPath << std::endl;
     }
 
+    const std::string& GetModelPath() const { return modelPath; }
+
+    void SetModelPath(const std::string& path) {
+        modelPath = path;
+        mesh = kInvalidMesh;
+    }
+
+    // The copy looks its mesh up again on its first draw
     std::shared_ptr<Component> Clone() const override {
-        return std::make_shared<Model>(*this);
+        auto copy = std::make_shared<Model>(*this);
+        copy->mesh = kInvalidMesh;
+        return copy;
     }
 
     // Add function to process component
 
+private:
+    std::string modelPath;
 };
@@ -1,214 +1,279 @@
 #pragma once
 
 #include "component.h"
+#include "core/physics/particle_store.h"
+#include "core/physics/simd_kernels.h"
+#include "core/physics/softbody_topology.h"
+#include "core/job_system.h"
 #include <glm/glm.hpp>
-#include "render/tiny_obj_loader.h"
-#include <unordered_map>
-
-struct DistanceConstraint {
-    uint32_t i0, i1;
-    float restLength;
-    float compliance; // 0 = rigid, >0 = soft
-    float lambda;     // persistent across frames
-};
-
-struct Edge {
-    uint32_t a, b;
-    bool operator==(const Edge& o) const {
-        return (a == o.a && b == o.b) || (a == o.b && b == o.a);
-    }
-};
-
-struct EdgeHash {
-    size_t operator()(const Edge& e) const {
-        return std::hash<uint32_t>()(e.a) ^
-               std::hash<uint32_t>()(e.b);
-    }
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// How SoftBody::SolveConstraints visits the constraints
+enum class SolverMode {
+    GaussSeidel, // in place, color by color; best convergence per iteration
+    Jacobi       // all constraints against the same positions, then averaged
 };
 
 class SoftBody : public Component
 {
+    // Jacobi scratch: deltaLambda * gradient of every constraint.
+    // Only allocated once the body is switched to Jacobi.
+    ParticleStore::FloatStream correctionX, correctionY, correctionZ;
+
+    // Jacobi pass 1: every constraint reads the same positions and stores its
+    // correction; nothing is written to the particles.
+    void ComputeJacobiCorrections(size_t begin, size_t end, float dt) {
+        const auto& constraints = topology->constraints;
+        const float alpha = compliance / (dt * dt);
+
+        for (size_t ci = begin; ci < end; ++ci) {
+            const DistanceConstraint& c = constraints[ci];
+
+            const float dx = particles.x[c.i1] - particles.x[c.i0];
+            const float dy = particles.y[c.i1] - particles.y[c.i0];
+            const float dz = particles.z[c.i1] - particles.z[c.i0];
+            const float len = std::sqrt(dx * dx + dy * dy + dz * dz);
+
+            const float wSum = particles.invMass[c.i0] + particles.invMass[c.i1];
+
+            float deltaLambda = 0.0f;
+            if (len >= 1e-6f) {
+                deltaLambda = (-(len - c.restLength) - alpha * lambdas[ci]) / (wSum + alpha);
+                lambdas[ci] += deltaLambda;
+            }
 
-    std::unordered_set<Edge, EdgeHash> edges;
-
-public:
-    std::vector<glm::vec3> restPositions;
+            const float scale = len >= 1e-6f ? deltaLambda / len : 0.0f;
+            correctionX[ci] = dx * scale;
+            correctionY[ci] = dy * scale;
+            correctionZ[ci] = dz * scale;
+        }
+    }
 
-    std::vector<glm::vec3> positions;
-    std::vector<glm::vec3> prevPositions;
+    // Jacobi pass 2: every particle gathers the corrections of its constraints
+    // and applies their average scaled by the relaxation factor.
+    void ApplyJacobiCorrections(size_t begin, size_t end) {
+        const auto& adjacencyOffsets = topology->adjacencyOffsets;
+        const auto& adjacency = topology->adjacency;
+
+        for (size_t i = begin; i < end; ++i) {
+            const uint32_t first = adjacencyOffsets[i];
+            const uint32_t last = adjacencyOffsets[i + 1];
+            if (first == last) continue;
+
+            float sx = 0.0f, sy = 0.0f, sz = 0.0f;
+            for (uint32_t a = first; a < last; ++a) {
+                const uint32_t c = adjacency[a] >> 1;
+                const float sign = (adjacency[a] & 1u) ? 1.0f : -1.0f;
+                sx += sign * correctionX[c];
+                sy += sign * correctionY[c];
+                sz += sign * correctionZ[c];
+            }
 
-    std::vector<float> invMass;
+            const float k = particles.invMass[i] * jacobiRelaxation / static_cast<float>(last - first);
+            particles.x[i] += k * sx;
+            particles.y[i] += k * sy;
+            particles.z[i] += k * sz;
+        }
+    }
 
-    std::vector<DistanceConstraint> constraints;
+public:
+    static constexpr COMPONENT_TYPE kType = SOFTBODY;
 
-    explicit SoftBody(const std::string& modelPath) {
-        std::cout << "Loading " << modelPath << std::endl;
+    // Colors smaller than this are solved on the calling thread
+    static constexpr size_t kParallelGrainSize = 512;
 
-        type = SOFTBODY;
+    // Shared, read only mesh data (rest shape, constraints, coloring)
+    std::shared_ptr<const SoftBodyTopology> topology;
 
-        tinyobj::attrib_t attrib;
-        std::vector<tinyobj::shape_t> shapes;
-        std::vector<tinyobj::material_t> materials;
-        std::string err;
+    // Simulation state (positions, previous positions, inverse masses) in SoA form
+    ParticleStore particles;
 
-        bool ok = tinyobj::LoadObj(&attrib, &shapes, &materials, &err, modelPath.c_str());
-        if (!ok) {
-            throw std::runtime_error(err);
-        }
+    // XPBD multiplier of every constraint, accumulated over one step
+    std::vector<float> lambdas;
 
-        // Map to keep only unique vertices by position
-        struct Vec3Hash {
-            size_t operator()(const glm::vec3& v) const {
-                return std::hash<float>()(v.x) ^ std::hash<float>()(v.y) ^ std::hash<float>()(v.z);
-            }
-        };
-
-        std::unordered_map<glm::vec3, uint32_t, Vec3Hash> posMap;
-        std::vector<uint32_t> indices;
-
-        // Collect vertices and triangulate faces
-        for (const auto& shape : shapes) {
-            size_t index_offset = 0;
-            for (size_t f = 0; f < shape.mesh.num_face_vertices.size(); ++f) {
-                int fv = shape.mesh.num_face_vertices[f];
-                if (fv < 3) continue; // ignore degenerate faces
-
-                // Get face indices
-                std::vector<uint32_t> faceIndices;
-                for (int j = 0; j < fv; ++j) {
-                    int idx = shape.mesh.indices[index_offset + j].vertex_index;
-                    glm::vec3 pos(
-                        attrib.vertices[3 * idx + 0],
-                        attrib.vertices[3 * idx + 1],
-                        attrib.vertices[3 * idx + 2]);
-
-                    auto it = posMap.find(pos);
-                    if (it == posMap.end()) {
-                        uint32_t newIndex = restPositions.size();
-                        restPositions.push_back(pos);
-                        posMap[pos] = newIndex;
-                        faceIndices.push_back(newIndex);
-                    } else {
-                        faceIndices.push_back(it->second);
-                    }
-                }
+    // 0 = rigid, >0 = soft
+    float compliance = 1e-6f;
 
-                // Triangulate quad or polygon face
-                for (int t = 1; t < fv - 1; ++t) {
-                    indices.push_back(faceIndices[0]);
-                    indices.push_back(faceIndices[t]);
-                    indices.push_back(faceIndices[t + 1]);
-                }
+    // Copy of the particle positions for the renderer, refreshed by WritePositions().
+    // One entry per render vertex, laid out exactly like the mesh's position buffer.
+    std::vector<glm::vec3> positions;
 
-                index_offset += fv;
-            }
-        }
+    // Model space bounds of `positions`, refreshed with them
+    glm::vec3 boundsMin = glm::vec3(0.0f);
+    glm::vec3 boundsMax = glm::vec3(0.0f);
 
-        // Initialize positions
-        positions = restPositions;
+    // Changes whenever `positions` is rewritten; unique across all bodies,
+    // so the renderer can tell a body it already uploaded from a new one
+    uint64_t positionsVersion = 0;
 
-        // Tiny offset for first frame to ensure cube falls
-        prevPositions = positions;
-        for (auto& p : prevPositions) p.y -= 0.001f;
+    SolverMode solverMode = SolverMode::GaussSeidel;
 
-        invMass.resize(positions.size(), 1.0f);
+    // Over-relaxation applied to the averaged Jacobi corrections (1 = plain average)
+    float jacobiRelaxation = 1.5f;
 
-        // Build unique edges from triangle indices
-        for (size_t i = 0; i < indices.size(); i += 3) {
-            uint32_t i0 = indices[i + 0];
-            uint32_t i1 = indices[i + 1];
-            uint32_t i2 = indices[i + 2];
+    explicit SoftBody(const std::string& modelPath)
+        : SoftBody(SoftBodyTopology::Load(modelPath)) {}
 
-            edges.insert({i0, i1});
-            edges.insert({i1, i2});
-            edges.insert({i2, i0});
-        }
+    explicit SoftBody(std::shared_ptr<const SoftBodyTopology> _topology)
+        : topology(std::move(_topology))
+    {
+        type = SOFTBODY;
 
-        // Create distance constraints
-        for (const auto& e : edges) {
-            float restLen = glm::length(restPositions[e.a] - restPositions[e.b]);
-            constraints.push_back({e.a, e.b, restLen, 1e-6f, 0.0f});
+        // Initialize positions
+        const auto& restPositions = topology->restPositions;
+        particles.Resize(restPositions.size());
+        for (size_t i = 0; i < restPositions.size(); ++i) {
+            particles.SetPosition(i, restPositions[i]);
+
+            // Tiny offset for first frame to ensure cube falls
+            particles.SetPrevPosition(i, restPositions[i] - glm::vec3(0.0f, 0.001f, 0.0f));
+            particles.invMass[i] = 1.0f;
         }
 
-        std::cout << "Soft body initialized: "
-                  << restPositions.size() << " vertices, "
-                  << edges.size() << " edges, "
-                  << constraints.size() << " constraints.\n";
+        lambdas.assign(topology->constraints.size(), 0.0f);
+        WritePositions();
     }
 
     void Integrate(float dt, glm::vec3 gravity)
     {
-        for (size_t i = 0; i < positions.size(); ++i)
-        {
-            if (invMass[i] == 0.0f) continue;
-
-            glm::vec3 temp = positions[i];
-            glm::vec3 velocity = positions[i] - prevPositions[i];
-
-            // Verlet integration
-            positions[i] += velocity + gravity * dt * dt;
-            prevPositions[i] = temp;
-        }
+        // Verlet integration, fixed particles are masked out inside the kernel
+        simd::IntegrateVerlet(particles, gravity, dt);
     }
 
 
     void SolveDistanceConstraint(
-    DistanceConstraint& c,
+    size_t index,
     float dt)
     {
-        glm::vec3& p0 = positions[c.i0];
-        glm::vec3& p1 = positions[c.i1];
+        const DistanceConstraint& c = topology->constraints[index];
 
-        glm::vec3 d = p1 - p0;
+        glm::vec3 d = particles.GetPosition(c.i1) - particles.GetPosition(c.i0);
         float len = glm::length(d);
         if (len < 1e-6f) return;
 
-        float w0 = invMass[c.i0];
-        float w1 = invMass[c.i1];
+        float w0 = particles.invMass[c.i0];
+        float w1 = particles.invMass[c.i1];
 
         float C = len - c.restLength;
 
         glm::vec3 grad = d / len;
         float wSum = w0 + w1;
 
-        float alpha = c.compliance / (dt * dt);
+        float alpha = compliance / (dt * dt);
         float deltaLambda =
-            (-C - alpha * c.lambda) / (wSum + alpha);
+            (-C - alpha * lambdas[index]) / (wSum + alpha);
 
-        c.lambda += deltaLambda;
+        lambdas[index] += deltaLambda;
 
-        p0 -= w0 * deltaLambda * grad;
-        p1 += w1 * deltaLambda * grad;
+        particles.SetPosition(c.i0, particles.GetPosition(c.i0) - w0 * deltaLambda * grad);
+        particles.SetPosition(c.i1, particles.GetPosition(c.i1) + w1 * deltaLambda * grad);
     }
 
+    // Gauss-Seidel over the constraints one color at a time. With a job system
+    // the constraints of a color are split across threads; ParallelFor returns only
+    // when the whole color is done, which is the barrier before the next color.
     void SolveConstraints(
     float dt,
-    int iterations = 6)
+    int iterations = 6,
+    JobSystem* jobs = nullptr)
     {
+        if (solverMode == SolverMode::Jacobi) {
+            SolveConstraintsJacobi(dt, iterations, jobs);
+            return;
+        }
+
+        const auto& colorOffsets = topology->colorOffsets;
         for (int it = 0; it < iterations; ++it) {
-            for (auto& c : constraints)
-                SolveDistanceConstraint(c, dt);
+            for (size_t color = 0; color < topology->GetColorCount(); ++color) {
+                const size_t begin = colorOffsets[color];
+                const size_t count = colorOffsets[color + 1] - begin;
+
+                if (!jobs || count < kParallelGrainSize) {
+                    for (size_t c = begin; c < begin + count; ++c)
+                        SolveDistanceConstraint(c, dt);
+                    continue;
+                }
+
+                jobs->ParallelFor(count, kParallelGrainSize, [&](size_t first, size_t last) {
+                    for (size_t c = begin + first; c < begin + last; ++c)
+                        SolveDistanceConstraint(c, dt);
+                });
+            }
         }
     }
 
-    void SolveFloorCollision(float floorY = 0.0f) {
-        for (size_t i = 0; i < positions.size(); ++i) {
-            if (invMass[i] == 0.0f) continue; // skip fixed points
-
-            // If below floor, push up
-            if (positions[i].y < floorY) {
-                float penetration = floorY - positions[i].y;
-                positions[i].y += penetration;
+    // Race free alternative to SolveConstraints: no coloring needed, every
+    // pass can be split across threads at any granularity.
+    void SolveConstraintsJacobi(
+    float dt,
+    int iterations = 6,
+    JobSystem* jobs = nullptr)
+    {
+        const size_t constraintCount = topology->constraints.size();
+        if (correctionX.size() != constraintCount) {
+            correctionX.assign(constraintCount, 0.0f);
+            correctionY.assign(constraintCount, 0.0f);
+            correctionZ.assign(constraintCount, 0.0f);
+        }
 
-                // Bounce factor (0 = no bounce, 1 = full)
-                float bounce = 0.2f;
-                prevPositions[i].y = positions[i].y + (prevPositions[i].y - positions[i].y) * (1.0f - bounce);
+        for (int it = 0; it < iterations; ++it) {
+            if (!jobs) {
+                ComputeJacobiCorrections(0, constraintCount, dt);
+                ApplyJacobiCorrections(0, particles.Size());
+                continue;
             }
 
+            jobs->ParallelFor(constraintCount, kParallelGrainSize, [&](size_t first, size_t last) {
+                ComputeJacobiCorrections(first, last, dt);
+            });
+            jobs->ParallelFor(particles.Size(), kParallelGrainSize, [&](size_t first, size_t last) {
+                ApplyJacobiCorrections(first, last);
+            });
         }
     }
 
+    // XPBD accumulates lambda over the iterations of a single step only
+    void ResetLambdas() {
+        std::fill(lambdas.begin(), lambdas.end(), 0.0f);
+    }
+
+    // One small XPBD step: predict, project the constraints, collide
+    void Substep(float dt, glm::vec3 gravity, int iterations = 1, JobSystem* jobs = nullptr) {
+        Integrate(dt, gravity);
+        ResetLambdas();
+        SolveConstraints(dt, iterations, jobs);
+        SolveFloorCollision(0.0f); // floor at y = 0
+    }
+
+    void SolveFloorCollision(float floorY = 0.0f) {
+        // Bounce factor (0 = no bounce, 1 = full)
+        constexpr float bounce = 0.2f;
+
+        // Floor is the half space above y = floorY
+        simd::CollideHalfSpace(particles, glm::vec3(0.0f, 1.0f, 0.0f), floorY, bounce);
+    }
+
+    // Copies the simulated particle positions into `positions` for rendering
+    void WritePositions() {
+        particles.GatherPositions(positions, topology->particleOfVertex);
+        particles.ComputeBounds(boundsMin, boundsMax);
+        positionsVersion = NextPositionsVersion();
+    }
+
+    static uint64_t NextPositionsVersion() {
+        static std::atomic<uint64_t> counter{0};
+        return ++counter;
+    }
+
+    // Shares the topology, copies only the per-instance state
     std::shared_ptr<Component> Clone() const override {
         return std::make_shared<SoftBody>(*this);
     }
-};
\ No newline at end of file
+};
@@ -6,11 +6,13 @@
 #include <glm/gtc/type_ptr.hpp>
 
 
+// Position, rotation (Euler degrees, applied X then Y then Z) and scale
+// relative to the parent object, or the world for roots. Change them through
+// the setters: they mark the transform dirty, and Scene::UpdateTransforms
+// rebuilds the cached matrices of dirty transforms and their descendants.
 class Transform: public Component {
 public:
-    glm::vec3 position;
-    glm::vec3 rotation;
-    glm::vec3 scale;
+    static constexpr COMPONENT_TYPE kType = TRANSFORM;
 
     Transform(const glm::vec3 pos = glm::vec3(0.0f, 0.0f, 0.0f),
              const glm::vec3 rot = glm::vec3(0.0f, 0.0f, 0.0f),
@@ -20,18 +22,57 @@ public:
         type = TRANSFORM;
     }
 
-    glm::mat4 GetModelMatrix(glm::vec3 bias)
+    const glm::vec3& GetPosition() const { return position; }
+    const glm::vec3& GetRotation() const { return rotation; }
+    const glm::vec3& GetScale() const { return scale; }
+
+    void SetPosition(const glm::vec3& pos) { position = pos; dirty = true; }
+    void SetRotation(const glm::vec3& rot) { rotation = rot; dirty = true; }
+    void SetScale(const glm::vec3& scl) { scale = scl; dirty = true; }
+
+    // True until the next Scene::UpdateTransforms after a setter call
+    bool IsDirty() const { return dirty; }
+
+    // Cached by the last Scene::UpdateTransforms
+    const glm::mat4& GetLocalMatrix() const { return localMatrix; }
+    const glm::mat4& GetWorldMatrix() const { return worldMatrix; }
+    // For normals
+    const glm::mat4& GetWorldInverseTranspose() const { return worldInverseTranspose; }
+
+    // World matrix of a mesh whose vertices are offset by bias
+    glm::mat4 GetModelMatrix(glm::vec3 bias) const
+    {
+        return glm::translate(glm::mat4(1.0f), -bias) * worldMatrix;
+    }
+
+    // translate * rotX * rotY * rotZ * scale of the local values
+    glm::mat4 ComputeLocalMatrix() const
     {
-        glm::mat4 modelMatrix(1.0f);
-        modelMatrix = glm::translate(glm::mat4(1.0f), position - bias)
+        return glm::translate(glm::mat4(1.0f), position)
             * glm::rotate(glm::mat4(1.0f), glm::radians(rotation[0]), glm::vec3(1.0f, 0.0f, 0.0f))
             * glm::rotate(glm::mat4(1.0f), glm::radians(rotation[1]), glm::vec3(0.0f, 1.0f, 0.0f))
             * glm::rotate(glm::mat4(1.0f), glm::radians(rotation[2]), glm::vec3(0.0f, 0.0f, 1.0f))
             * glm::scale(glm::mat4(1.0f), scale);
-
-        return modelMatrix;
     }
+
+    // The copy is dirty, so its matrices are rebuilt for its new object
     std::shared_ptr<Component> Clone() const override {
-        return std::make_shared<Transform>(*this);
+        auto copy = std::make_shared<Transform>(*this);
+        copy->dirty = true;
+        return copy;
     }
+
+private:
+    friend class TransformHierarchy;
+
+    glm::vec3 position;
+    glm::vec3 rotation;
+    glm::vec3 scale;
+
+    glm::mat4 localMatrix = glm::mat4(1.0f);
+    glm::mat4 localInverseTranspose = glm::mat4(1.0f);
+    glm::mat4 worldMatrix = glm::mat4(1.0f);
+    glm::mat4 worldInverseTranspose = glm::mat4(1.0f);
+
+    bool dirty = true;
 };
@@ -2,11 +2,11 @@
 
 #include <iostream>
 #include <string>
-#include <array>
-#include <unordered_set>
 #include <memory>
 #include <vector>
 
+#include "component_registry.h"
+#include "slot_map.h"
 #include "components/component.h"
 #include "components/transform.h"
 #include "components/material.h"
@@ -14,85 +14,84 @@
 #include "components/light.h"
 #include "components/softbody.h"
 
+// Generational handle of a GameObject in its Scene
+using ObjectHandle = SlotHandle;
+
+// Created and destroyed by a Scene, which stores it in place; hold on to it
+// through its ObjectHandle
 class GameObject {
 public:
-    std::string name;
-    // Contains all the compenents associated with the game object
-    // If the game object does not have that component, the element where
-    // that component should be is null.
-    std::array<std::shared_ptr<Component>, Component::GetEnumSize()> components{};
-    std::unordered_set<std::string> tags;
+    GameObject() = default;
+    ~GameObject() {
+        if (registry) registry->Remove(*this);
+    }
+
+    GameObject(const GameObject&) = delete;
+    GameObject& operator=(const GameObject&) = delete;
+
+    ObjectHandle GetHandle() const { return handle; }
 
-    GameObject() : id(generateUniqueId()) {}
-    const int id;
+    // Renamed and tagged through the Scene, which indexes both
+    const std::string& GetName() const { return name; }
+
+    // Slots are reused, so pools indexed by entity stay dense
+    Entity GetEntity() const { return handle.index; }
 
     Transform* GetTransform() const {
-        return dynamic_cast<Transform*>(components[TRANSFORM].get());
+        return GetComponent<Transform>();
     }
 
-    // returns a reference to the component of the given type
+    // returns the component of the given type, or nullptr if the object has none
     Component* GetComponent(COMPONENT_TYPE type) const {
-        return components[type].get();
+        return registry ? registry->GetComponent(GetEntity(), type) : nullptr;
     }
 
-    // returns a reference to the component by the index
-    /*Component* GetComponent(size_t index) {
-        return components[index].get();
-    }*/
+    // returns the component of type T, or nullptr if the object has none.
+    // Components live in the scene's pools: the pointer is good until a
+    // component of the same type is added to or removed from any object.
+    template <typename T>
+    T* GetComponent() const {
+        return registry ? registry->Pool<T>().Get(GetEntity()) : nullptr;
+    }
 
     // returns the amount of components
     int GetComponentCount() const {
         int count = 0;
 
-        for(const std::shared_ptr<Component>& component : components) {
-            if(component) {
+        for(size_t type = 0; type < NUM_ENUM; ++type) {
+            if(GetComponent(static_cast<COMPONENT_TYPE>(type))) {
                 count++;
             }
         }
         return count;
     }
 
-    // returns true if tag is present in the game object
-    bool CompareTag(const std::string& tag) const {
-        return tags.find(tag) != tags.end();
-    }
-
-    // adds a tag to the game object
-    void AddTag(const std::string& tag) {
-        tags.insert(tag);
-    }
-
-    // removes a tag from the game object
-    void RemoveTag(const std::string& tag) {
-        tags.erase(tag);
+    // Puts the component in its type's pool, replacing what was there
+    template <typename T>
+    T* SetComponent(T component) {
+        if(!registry) return nullptr;
+        return &registry->SetComponent(GetEntity(), std::move(component));
     }
 
     void AddComponent(const COMPONENT_TYPE component) {
+        if(GetComponent(component)) return;
+
         switch(component) {
             // case TRANSFORM:
-            //     if(!components[TRANSFORM]) {
-            //         components[TRANSFORM] = std::make_shared<Transform>();
-            //     }
+            //     SetComponent(Transform());
             //     break;
             case MATERIAL:
-                if(!components[MATERIAL]) {
-                    components[MATERIAL] = std::make_shared<Material>();
-                }
+                SetComponent(Material());
                 break;
             case MODEL:
-                if(!components[MODEL]) {
-                    components[MODEL] = std::make_shared<Model>();
-                }
+                SetComponent(Model());
                 break;
             case LIGHT:
-                if(!components[LIGHT]) {
-                    components[LIGHT] = std::make_shared<PointLight>();
-                }
+                SetComponent(PointLight());
                 break;
             case SOFTBODY:
-                if(!components[SOFTBODY]) {
-                    auto modelPath = dynamic_cast<Model*>(components[MODEL].get())->modelPath;
-                    components[SOFTBODY] = std::make_shared<SoftBody>(modelPath);
+                if(const Model* model = GetComponent<Model>()) {
+                    SetComponent(SoftBody(model->GetModelPath()));
                 }
             default: ;
         }
@@ -100,26 +99,33 @@ public:
 
     // Don't call on transform
     void RemoveComponent(COMPONENT_TYPE type) {
-        if(components[type] && type != TRANSFORM) {
-            components[type] = nullptr;
+        if(registry && type != TRANSFORM) {
+            registry->RemoveComponent(GetEntity(), type);
         }
     }
 
-    void CopyComponent(const std::shared_ptr<Component> component) {
-        if(component) {
-            COMPONENT_TYPE type = component->type;
-            components[type] = component->Clone();
+    // Gives the object a copy of another object's component, made by Clone
+    // so each type's copy rules apply
+    void CopyComponent(const Component* component) {
+        if(component && registry) {
+            const std::shared_ptr<Component> copy = component->Clone();
+            registry->SetComponent(GetEntity(), std::move(*copy));
         }
     }
 
     bool operator==(const GameObject& other) const
     {
-        return id == other.id;
+        return handle == other.handle;
     }
 private:
-    static int lastId;
+    friend class ComponentRegistry;
+    friend class Scene;
 
-    static int generateUniqueId() {
-        return lastId++;
-    }
+    // Set by the Scene that created the object
+    ObjectHandle handle;
+    std::string name;
+
+    // Pools of the scene the object is in, which hold its components; null
+    // while the object is in no scene
+    ComponentRegistry* registry = nullptr;
 };
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Counts outstanding jobs; JobSystem::Wait blocks until it reaches zero
+struct JobCounter {
+    std::atomic<int> value{0};
+};
+
+class JobSystem;
+
+// Set of jobs with "runs after" edges between them. Every node starts once all
+// of its predecessors finished. A graph can be run any number of times.
+class TaskGraph {
+public:
+    using NodeId = size_t;
+
+    NodeId Add(std::function<void()> fn);
+
+    // `after` will not start before `before` has finished
+    void Precede(NodeId before, NodeId after);
+
+    // Runs the whole graph and returns when every node is done
+    void Run(JobSystem& jobs);
+
+    size_t Size() const { return nodes.size(); }
+
+private:
+    struct Node {
+        std::function<void()> fn;
+        std::vector<NodeId> successors;
+        int predecessorCount = 0;
+        std::atomic<int> pending{0};
+    };
+
+    void Launch(JobSystem& jobs, NodeId id, JobCounter& done);
+
+    // unique_ptr keeps the atomics in place while the vector grows
+    std::vector<std::unique_ptr<Node>> nodes;
+};
+
+// Work stealing scheduler shared by the whole engine.
+// Every worker owns a deque: it pushes and pops its own jobs at the back while
+// idle workers steal from the front of the others. Threads that are not
+// workers (e.g. the main thread) submit into a shared queue, and while they
+// Wait they run queued jobs too, so waiting inside a job never deadlocks.
+//
+// With a thread count of 1 there are no workers and every job runs inline on
+// the submitting thread, which keeps execution order deterministic for debugging.
+//
+// Destruction runs every job that is still queued before the workers exit;
+// TakeBackgroundJobs first if the queued background jobs should not hold it up.
+class JobSystem {
+public:
+    using Job = std::function<void()>;
+
+    // threadCount includes the calling thread; 0 picks the hardware thread count
+    explicit JobSystem(size_t threadCount = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    size_t GetThreadCount() const { return workers.size() + 1; }
+    bool IsSingleThreaded() const { return workers.empty(); }
+
+    // Queues a job. If a counter is given it is incremented now and
+    // decremented once the job has run. Jobs must not throw.
+    void Submit(Job job, JobCounter* counter = nullptr);
+
+    // Queues a long running job (asset loading and the like). Only workers
+    // run these, and only when no regular job is waiting, so a thread blocked
+    // in Wait() never ends up running one. Runs inline when single threaded.
+    void SubmitBackground(Job job);
+
+    // Stops queueing background jobs and returns the queued ones that have
+    // not started, e.g. to hand them to a replacement JobSystem. Background
+    // jobs submitted afterwards run inline; running ones are not affected.
+    std::vector<Job> TakeBackgroundJobs();
+
+    // The JobSystem whose worker is running the calling thread, nullptr on
+    // any other thread. Background jobs look their system up through this
+    // instead of capturing it, so they can move to another one.
+    static JobSystem* Current();
+
+    // Runs queued jobs on this thread until the counter drops to zero
+    void Wait(JobCounter& counter);
+
+    // Calls fn(begin, end) over [0, count) in chunks of grainSize and returns
+    // when all chunks are done
+    void ParallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& fn);
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    void WorkerLoop(size_t index);
+
+    // Own queue from the back, then everyone else's from the front
+    bool TryRunJob(size_t ownQueue);
+    bool PopBack(size_t queue, Job& job);
+    bool StealFront(size_t queue, Job& job);
+    bool TryRunBackgroundJob();
+
+    bool HasQueuedJobs() const;
+
+    // Queue the calling thread pushes to: its own deque for workers, the shared one otherwise
+    size_t CurrentQueue() const;
+
+    std::vector<std::thread> workers;
+
+    // One deque per worker plus a shared one (the last) for outside threads
+    std::vector<std::unique_ptr<Queue>> queues;
+
+    std::atomic<size_t> queuedJobs{0};
+
+    // FIFO, shared by all workers
+    Queue backgroundQueue;
+    std::atomic<size_t> queuedBackgroundJobs{0};
+    bool backgroundClosed = false; // guarded by backgroundQueue.mutex
+
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+    std::atomic<bool> stopping{false};
+};
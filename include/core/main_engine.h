@@ -5,7 +5,10 @@
 #include "components/transform.h"
 #include "components/light.h"
 #include "scene.h"
+#include "job_system.h"
+#include "physics_system.h"
 #include "GLFW/glfw3.h"
+#include <memory>
 #include <unordered_map>
 
 class MainEngine
@@ -36,36 +39,29 @@ private:
         };
         for (int i = 0; i < n; i++)
         {
-            scene->AddModel();
-            const auto& obj = scene->GetModels().at(i);
+            const ObjectHandle cube = scene->AddModel();
 
-            std::dynamic_pointer_cast<Transform>(obj->components[TRANSFORM])->position = pos[i];
+            scene->GetObject(cube)->GetTransform()->SetPosition(pos[i]);
         }
 
         // Make floor
 
-        scene->AddModel("square.obj", "floor");
-        const auto &obj = scene->GetModels().at(1);
+        GameObject* obj = scene->GetObject(scene->AddModel("square.obj", "floor"));
 
-        std::dynamic_pointer_cast<Transform>(obj->components[TRANSFORM])->position = {0.f, 0.f, 0.f};
-        std::dynamic_pointer_cast<Transform>(obj->components[TRANSFORM])->rotation = {-90.f, 0.f, 0.f};
-        std::dynamic_pointer_cast<Transform>(obj->components[TRANSFORM])->scale = {100.f, 100.f, 100.f};
+        obj->GetTransform()->SetPosition({0.f, 0.f, 0.f});
+        obj->GetTransform()->SetRotation({-90.f, 0.f, 0.f});
+        obj->GetTransform()->SetScale({100.f, 100.f, 100.f});
 
         // Make Light
-        const auto light1 = std::make_shared<GameObject>();
-        const auto lightTransform1 = std::make_shared<Transform>(
+        GameObject* light1 = scene->GetObject(scene->CreateLight());
+        light1->SetComponent(Transform(
             glm::vec3(0.0f, 20.0f, -30.0f),
             glm::vec3(0.0f, 0.0f, 0.0f),
-            glm::vec3(0.0f, 0.0f, 0.0f));
+            glm::vec3(0.0f, 0.0f, 0.0f)));
 
-        const auto lightComp1 = std::make_shared<PointLight>(
+        light1->SetComponent(PointLight(
             glm::vec3(0.5f, 0.5f, 0.5f),
-                1.0f);
-
-        light1->components[TRANSFORM] = lightTransform1;
-        light1->components[LIGHT] = lightComp1;
-
-        scene->GetLights().emplace_back(light1);
+                1.0f));
 
         scenes.push_back(scene);
     }
@@ -79,18 +75,40 @@ public:
 
     float cameraSense = 0.1f;
     float movementSense = 1.f;
-    glm::vec3 gravity = {0, -9.81f, 0};
 
     bool mouseDragging = false;
     glm::vec2 lastMousePos = glm::vec2(0.0f);
 
     bool simulationRunning = false;
 
+    // Fixed step soft body simulation of the current scene
+    PhysicsSystem physics;
+
+    // Engine wide scheduler; physics, asset loading and culling submit work here
+    std::unique_ptr<JobSystem> jobSystem;
+
     MainEngine()
     {
+        jobSystem = std::make_unique<JobSystem>();
         TestInit2();
     }
 
+    JobSystem& GetJobSystem() { return *jobSystem; }
+
+    // 0 = one thread per hardware thread, 1 = run every job inline (debugging).
+    // Blocks until the jobs already running on the old workers are done, at
+    // most one background mesh load each. Queued loads are not run first but
+    // moved to the new system (with 1 thread they then run inline here).
+    void SetThreadCount(size_t threadCount) {
+        std::vector<JobSystem::Job> pending = jobSystem->TakeBackgroundJobs();
+        jobSystem.reset();
+        jobSystem = std::make_unique<JobSystem>(threadCount);
+
+        for (JobSystem::Job& job : pending) {
+            jobSystem->SubmitBackground(std::move(job));
+        }
+    }
+
 
     bool HasChangedScene() const { return changedScene; }
     void ChangedSceneAcknowledged() { changedScene = false; }
@@ -114,4 +132,7 @@ public:
     void MouseCallback(GLFWwindow *window, int button, int action, int mods);
 
     void runSimulation();
+
+    // Per body step times of the last frame that ran a step, in stepping order
+    const std::vector<BodyStepStats>& GetBodyStepStats() const { return physics.GetBodyStepStats(); }
 };
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Reverse Cuthill-McKee ordering of a triangle mesh's vertex graph.
+// Neighbouring vertices end up close together in memory, which keeps the
+// particle accesses of the constraint solver inside a few cache lines.
+// Returns order where order[newIndex] = oldIndex.
+std::vector<uint32_t> ReverseCuthillMcKee(size_t vertexCount, const std::vector<uint32_t>& triangleIndices);
+
+// Inverts a permutation: result[order[i]] = i
+std::vector<uint32_t> InvertPermutation(const std::vector<uint32_t>& order);
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+#include <glm/glm.hpp>
+
+// Allocator handing out storage aligned for the widest SIMD register we use
+template <typename T, size_t Alignment>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    void deallocate(T* p, size_t) {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; }
+};
+
+// Structure-of-arrays particle storage used by the soft body solver.
+// Every stream is padded to a multiple of kLaneWidth so the SIMD kernels never
+// need a scalar tail. Padding particles have invMass == 0 and are ignored.
+class ParticleStore {
+public:
+    static constexpr size_t kLaneWidth = 8;   // floats per AVX register
+    static constexpr size_t kAlignment = 32;  // bytes
+
+    using FloatStream = std::vector<float, AlignedAllocator<float, kAlignment>>;
+
+    FloatStream x, y, z;       // current positions
+    FloatStream px, py, pz;    // previous positions
+    FloatStream invMass;
+
+    size_t Size() const { return count; }
+    size_t PaddedSize() const { return x.size(); }
+
+    void Resize(size_t n) {
+        count = n;
+        const size_t padded = (n + kLaneWidth - 1) / kLaneWidth * kLaneWidth;
+        for (FloatStream* s : {&x, &y, &z, &px, &py, &pz, &invMass}) {
+            s->assign(padded, 0.0f);
+        }
+    }
+
+    glm::vec3 GetPosition(size_t i) const { return {x[i], y[i], z[i]}; }
+    glm::vec3 GetPrevPosition(size_t i) const { return {px[i], py[i], pz[i]}; }
+
+    void SetPosition(size_t i, const glm::vec3& p) {
+        x[i] = p.x; y[i] = p.y; z[i] = p.z;
+    }
+
+    void SetPrevPosition(size_t i, const glm::vec3& p) {
+        px[i] = p.x; py[i] = p.y; pz[i] = p.z;
+    }
+
+    // Copies the current positions into an array of vec3 (e.g. for rendering)
+    void GatherPositions(std::vector<glm::vec3>& out) const {
+        out.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = {x[i], y[i], z[i]};
+        }
+    }
+
+    // Same as above, but out[i] is particle remap[i]
+    void GatherPositions(std::vector<glm::vec3>& out, const std::vector<uint32_t>& remap) const {
+        out.resize(remap.size());
+        for (size_t i = 0; i < remap.size(); ++i) {
+            const uint32_t p = remap[i];
+            out[i] = {x[p], y[p], z[p]};
+        }
+    }
+
+    // Axis aligned bounds of the particles; untouched when there are none
+    void ComputeBounds(glm::vec3& boundsMin, glm::vec3& boundsMax) const {
+        if (count == 0) return;
+
+        float minX = x[0], minY = y[0], minZ = z[0];
+        float maxX = minX, maxY = minY, maxZ = minZ;
+        for (size_t i = 1; i < count; ++i) {
+            minX = std::min(minX, x[i]); maxX = std::max(maxX, x[i]);
+            minY = std::min(minY, y[i]); maxY = std::max(maxY, y[i]);
+            minZ = std::min(minZ, z[i]); maxZ = std::max(maxZ, z[i]);
+        }
+        boundsMin = {minX, minY, minZ};
+        boundsMax = {maxX, maxY, maxZ};
+    }
+
+private:
+    size_t count = 0;
+};
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "particle_store.h"
+
+// Vectorised particle passes over a ParticleStore.
+// Each kernel picks the widest instruction set the CPU supports at runtime
+// (AVX2, then SSE2, then scalar) and uses lane masks rather than branches,
+// so fixed particles (invMass == 0) and padding are simply left untouched.
+namespace simd {
+
+    enum class InstructionSet { Scalar, SSE2, AVX2 };
+
+    // Widest instruction set the CPU supports, detected on first use. Other
+    // SIMD code (e.g. the renderer's culling) dispatches on this too.
+    InstructionSet ActiveSet();
+
+    // Name of the instruction set the kernels dispatch to ("avx2", "sse2" or "scalar")
+    const char* ActiveInstructionSet();
+
+    // Verlet step: x' = x + (x - prev) + accel * dt^2, prev' = x
+    void IntegrateVerlet(ParticleStore& particles, const glm::vec3& gravity, float dt);
+
+    // Pushes particles out of the half space dot(n, p) < offset and damps the
+    // normal component of their implicit velocity by the bounce factor.
+    void CollideHalfSpace(ParticleStore& particles, const glm::vec3& normal, float offset, float bounce);
+
+}
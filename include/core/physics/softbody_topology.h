@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+struct WeldedMesh;
+
+struct DistanceConstraint {
+    uint32_t i0, i1;   // particle indices, i0 < i1
+    float restLength;
+};
+
+// Everything about a soft body mesh that does not change while simulating.
+// Built once per model path and shared (read only) by every SoftBody using it,
+// so spawning or cloning a body only allocates its per-instance state.
+struct SoftBodyTopology {
+    std::string modelPath;
+
+    // Rest shape in particle order (reverse Cuthill-McKee, see mesh_reorder.h)
+    std::vector<glm::vec3> restPositions;
+
+    // particleOfVertex[renderVertex] = particle index after welding and the
+    // load-time reordering. Several render vertices can share a particle.
+    std::vector<uint32_t> particleOfVertex;
+
+    // Grouped by color: constraints[colorOffsets[k] .. colorOffsets[k + 1]) have
+    // color k and never share a particle. Sorted by (i0, i1) inside a color.
+    std::vector<DistanceConstraint> constraints;
+    std::vector<uint32_t> colorOffsets;
+
+    // Per particle list of the constraints touching it (CSR layout) for the
+    // Jacobi gather. Each entry is (constraint index << 1) | side, side 1 = i1.
+    std::vector<uint32_t> adjacencyOffsets;
+    std::vector<uint32_t> adjacency;
+
+    size_t GetParticleCount() const { return restPositions.size(); }
+
+    size_t GetColorCount() const {
+        return colorOffsets.empty() ? 0 : colorOffsets.size() - 1;
+    }
+
+    // Returns the topology for a model from the AssetRegistry, building it on
+    // first use. Safe to call from several threads. Throws std::runtime_error
+    // if the OBJ cannot be loaded.
+    static std::shared_ptr<const SoftBodyTopology> Load(const std::string& modelPath);
+
+    // Builds a fresh topology, bypassing the registry
+    static std::shared_ptr<SoftBodyTopology> Build(const std::string& modelPath);
+    static std::shared_ptr<SoftBodyTopology> Build(const std::string& modelPath, const WeldedMesh& mesh);
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "scene.h"
+#include "job_system.h"
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+
+// Time one soft body spent stepping during the last simulated frame
+struct BodyStepStats {
+    ObjectHandle object;
+    std::string name;
+    float milliseconds;
+};
+
+// Fixed step soft body simulation of a scene. Knows nothing about windows or
+// OpenGL, so the editor and the headless runner share the exact same stepping.
+class PhysicsSystem
+{
+private:
+    // Soft bodies stepped this frame, in the order of the scene's SoftBody pool
+    std::vector<SoftBody*> activeBodies;
+    std::vector<BodyStepStats> bodyStepStats;
+
+    // Points activeBodies at the bodies in the scene's SoftBody pool
+    void CollectActiveBodies(Scene& scene);
+
+    // Advances every active body by dt, split into `substeps` XPBD substeps
+    void StepBodies(float dt, JobSystem& jobs);
+
+public:
+    glm::vec3 gravity = {0, -9.81f, 0};
+
+    // Fixed step simulation: wall clock time is banked in the accumulator and
+    // spent in steps of fixedTimeStep, each split into `substeps` XPBD substeps
+    // with one solver iteration.
+    float fixedTimeStep = 1.0f / 60.0f;
+    int substeps = 8;
+    // Upper bound on catch-up steps per frame; older backlog is dropped
+    int maxStepsPerFrame = 4;
+    float timeAccumulator = 0.0f;
+
+    // Banks frameTime and runs as many fixed steps as it pays for.
+    // Returns the number of steps taken.
+    int Update(Scene& scene, float frameTime, JobSystem& jobs);
+
+    // Runs `steps` fixed steps back to back, ignoring the accumulator
+    void Step(Scene& scene, JobSystem& jobs, int steps = 1);
+
+    const std::vector<BodyStepStats>& GetBodyStepStats() const { return bodyStepStats; }
+};
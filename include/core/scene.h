@@ -1,9 +1,14 @@
 #pragma once
 
+#include <algorithm>
+#include <cassert>
 #include <iostream>
 #include <ostream>
 
 #include "core/game_object.h"
+#include "core/scene_index.h"
+#include "core/slot_map.h"
+#include "core/transform_hierarchy.h"
 #include "core/camera.h"
 #include "core/components/transform.h"
 #include "core/components/model.h"
@@ -15,10 +20,48 @@
 
 class Scene {
 private:
-    std::vector<std::shared_ptr<GameObject>> 	models;
-    std::vector<std::shared_ptr<GameObject>> 	lights;
+    // Declared before the objects so it outlives them
+    ComponentRegistry                           registry;
+
+    // Every model and light, stored in place
+    SlotMap<GameObject>                         objects;
+
+    std::vector<ObjectHandle>                   models;
+    std::vector<ObjectHandle>                   lights;
     std::vector<std::shared_ptr<Camera>> 		cameras;
 
+    // Where each object slot's handle is in models or lights, so removal
+    // does not search
+    struct ObjectPlacement {
+        bool light;
+        uint32_t position;
+    };
+    std::vector<ObjectPlacement>                placements;
+
+    // Name and tag lookups
+    SceneIndex                                  index;
+
+    // Parent/child links and the world matrix pass
+    TransformHierarchy                          hierarchy;
+
+    ObjectHandle CreateObject(bool light)
+    {
+        const ObjectHandle handle = objects.Emplace();
+        GameObject* object = objects.Get(handle);
+        object->handle = handle;
+        registry.Add(*object);
+        index.Add(handle, object->name);
+
+        auto& list = light ? lights : models;
+        if (handle.index >= placements.size()) {
+            placements.resize(handle.index + 1);
+        }
+        placements[handle.index] = {light, static_cast<uint32_t>(list.size())};
+        list.push_back(handle);
+
+        return handle;
+    }
+
 	// Directional Light Info
 
 	float lightNearPlane = 0.1f, lightFarPlane = 50.f;
@@ -78,23 +121,34 @@ public:
 		lightSpaceMatrix = lightProjection * lightView;
 	}
 
-    std::shared_ptr<GameObject> selectedGameObj = nullptr;
-    bool mOrL; // Model or Light object
+    // Weak: resolves to nullptr once the object is destroyed
+    ObjectHandle selectedGameObj;
 
     std::shared_ptr<Camera> selectedCamera = nullptr;
 
 	int current_shader = 1;
 
     Scene() = default;
-  	std::vector<std::shared_ptr<GameObject>>& 	GetModels()
+
+  	const std::vector<ObjectHandle>& 	GetModels() const
     {
         return models;
     }
-    std::vector<std::shared_ptr<GameObject>>& 	GetLights()
+    const std::vector<ObjectHandle>& 	GetLights() const
     {
         return lights;
     }
 
+    // nullptr once the object has been destroyed
+    GameObject* GetObject(ObjectHandle handle) const
+    {
+        return objects.Get(handle);
+    }
+
+    // Component pools of every model and light in the scene
+    ComponentRegistry& GetRegistry() { return registry; }
+    const ComponentRegistry& GetRegistry() const { return registry; }
+
     std::vector<std::shared_ptr<Camera>>& 	    GetCameras()
   	{
   	    return cameras;
@@ -108,12 +162,31 @@ public:
   	    }
         return cameras.at(currCameraIdx);
     }
-    void AddModel(const std::shared_ptr<GameObject>& model)
+    // Empty objects; give them a Transform before anything draws them
+    ObjectHandle CreateModel() { return CreateObject(false); }
+    ObjectHandle CreateLight() { return CreateObject(true); }
+
+    // Destroys a model or a light; stale handles are ignored
+    void DestroyObject(ObjectHandle handle)
     {
-        models.push_back(model);
+        GameObject* object = objects.Get(handle);
+        if (!object) return;
+
+        registry.Remove(*object);
+        index.Remove(handle);
+        hierarchy.Remove(handle);
+
+        // Fill the hole with the list's last handle
+        const ObjectPlacement placement = placements[handle.index];
+        auto& list = placement.light ? lights : models;
+        list[placement.position] = list.back();
+        placements[list.back().index].position = placement.position;
+        list.pop_back();
+
+        objects.Erase(handle);
     }
 
-    void AddModel(const std::string& objFile, const std::string& name)
+    ObjectHandle AddModel(const std::string& objFile, const std::string& name)
   	{
   	    std::cout << objFile << std::endl;
   	    if (objFile.find(".obj") == std::string::npos)
@@ -124,53 +197,38 @@ public:
 
         glm::vec3 pos= {0.0f, 0.0f, 0.0f};
 
-        auto obj = std::make_shared<GameObject>();
+        const ObjectHandle handle = CreateModel();
+        GameObject* obj = objects.Get(handle);
   		if(name.empty()) {
-  			obj->name = objFile.substr(0, objFile.find_last_of('.')) + std::to_string(randomId++);
+  			SetObjectName(handle, objFile.substr(0, objFile.find_last_of('.')) + std::to_string(randomId++));
   		}
   		else {
-  			obj->name = name;
+  			SetObjectName(handle, name);
   		}
 
-        const auto objTransform = std::make_shared<Transform>(pos);
-        const auto objMaterial = std::make_shared<Material>();
-  	    const auto objModel = std::make_shared<Model>(objFile);
+        obj->SetComponent(Transform(pos));
+        obj->SetComponent(Material());
+  	    obj->SetComponent(Model(objFile));
 
-        obj->components[TRANSFORM] = objTransform;
-        obj->components[MATERIAL] = objMaterial;
-  	    obj->components[MODEL] = objModel;
-
-
-        AddModel(obj);
+        return handle;
   	}
 
-    void AddModel(){
+    ObjectHandle AddModel(){
         glm::vec3 pos = {0.0f, 0.0f, 0.0f};
 
-        const auto obj = std::make_shared<GameObject>();
+        const ObjectHandle handle = CreateModel();
+        GameObject* obj = objects.Get(handle);
         const auto name = std::string("object" + std::to_string(randomId++));
-        const auto transform = std::make_shared<Transform>(pos);
-        const auto material = std::make_shared<Material>();
-  	    const auto model = std::make_shared<Model>();
-
-        obj->name = name;
-        obj->components[TRANSFORM] = transform;
-        obj->components[MATERIAL] = material;
-  	    obj->components[MODEL] = model;
+        SetObjectName(handle, name);
+        obj->SetComponent(Transform(pos));
+        obj->SetComponent(Material());
+  	    const Model* model = obj->SetComponent(Model());
 
-  	    std::cout << std::dynamic_pointer_cast<Model>(obj->components[MODEL])->modelPath << std::endl;
+  	    std::cout << model->GetModelPath() << std::endl;
 
-        AddModel(obj);
+        return handle;
     };
 
-    void SetLightsVector(const std::vector<std::shared_ptr<GameObject>>& _lights) {
-        lights = _lights;
-    }
-
-    void SetModelsVector(const std::vector<std::shared_ptr<GameObject>>& _models) {
-        models = _models;
-    }
-
     std::string& GetName() {
         return name;
     }
@@ -184,79 +242,90 @@ public:
 	void SetCurrCameraIdx(int i){ currCameraIdx = i; };
 
 
-	// returns a vector of game objects containing specific tag
-	std::vector<std::shared_ptr<GameObject>> SearchByTag(const std::string& tag) {
-		std::vector<std::shared_ptr<GameObject>> gameObjects;
+    // Parents child to parent, or makes it a root for an invalid parent
+    // handle. False for dead handles or if it would make a cycle.
+    bool SetParent(ObjectHandle child, ObjectHandle parent)
+    {
+        if (!objects.Get(child)) return false;
+        if (parent.index != SlotHandle::kNoIndex && !objects.Get(parent)) return false;
+        return hierarchy.SetParent(child, parent);
+    }
 
-		for(const std::shared_ptr<GameObject>& model : models) {
-			if(model->CompareTag(tag)) {
-				gameObjects.push_back(model);
-			}
-		}
+    ObjectHandle GetParent(ObjectHandle handle) const { return hierarchy.GetParent(handle); }
+    const std::vector<ObjectHandle>& GetChildren(ObjectHandle handle) const { return hierarchy.GetChildren(handle); }
 
-		for(const std::shared_ptr<GameObject>& light : lights) {
-			if(light->CompareTag(tag)) {
-				gameObjects.push_back(light);
-			}
-		}
+    // Brings the cached matrices of every moved Transform, and of everything
+    // below it, up to date. Call once per frame before reading them.
+    void UpdateTransforms() { hierarchy.Update(registry); }
 
-		return gameObjects;
-	}
+    void SetObjectName(ObjectHandle handle, const std::string& name)
+    {
+        GameObject* object = objects.Get(handle);
+        if (!object) return;
 
-	// returns a vector of game objects containing specific component
-	std::vector<std::shared_ptr<GameObject>> SearchByComponent(COMPONENT_TYPE type) {
-		std::vector<std::shared_ptr<GameObject>> gameObjects;
+        object->name = name;
+        index.Rename(handle, name);
+    }
 
-		for(const std::shared_ptr<GameObject>& model : models) {
-			if(model->GetComponent(type)) {
-				gameObjects.push_back(model);
-			}
-		}
+    // Tags are interned; TagIds are only valid in the scene that made them
+    TagId InternTag(const std::string& tag) { return index.InternTag(tag); }
+    TagId FindTag(const std::string& tag) const { return index.FindTag(tag); }
 
-		for(const std::shared_ptr<GameObject>& light : lights) {
-			if(light->GetComponent(type)) {
-				gameObjects.push_back(light);
-			}
-		}
+    void AddTag(ObjectHandle handle, const std::string& tag)
+    {
+        if (objects.Get(handle)) index.AddTag(handle, index.InternTag(tag));
+    }
 
-		return gameObjects;
-	}
+    void RemoveTag(ObjectHandle handle, const std::string& tag)
+    {
+        const TagId id = index.FindTag(tag);
+        if (objects.Get(handle) && id != kNoTag) index.RemoveTag(handle, id);
+    }
 
-	// returns a vector of game objects with specific name
-	std::vector<std::shared_ptr<GameObject>> SearchByName(const std::string& name) {
-		std::vector<std::shared_ptr<GameObject>> gameObjects;
+    bool HasTag(ObjectHandle handle, TagId tag) const
+    {
+        return objects.Get(handle) && index.HasTag(handle, tag);
+    }
 
-		for(const std::shared_ptr<GameObject>& model : models) {
-			if(model->name == name) {
-				gameObjects.push_back(model);
-			}
-		}
+	// Objects with exactly this name / tag, in no particular order. The
+	// vectors are the index's own: don't hold on to them across edits.
+	const std::vector<ObjectHandle>& FindByName(const std::string& name) const { return index.FindByName(name); }
+	const std::vector<ObjectHandle>& FindByTag(TagId tag) const { return index.FindByTag(tag); }
 
-		for(const std::shared_ptr<GameObject>& light : lights) {
-			if(light->name == name) {
-				gameObjects.push_back(light);
-			}
-		}
+	// Calls fn(ObjectHandle) for every object whose name contains text
+	template <typename Fn>
+	void ForEachNameContaining(const std::string& text, Fn&& fn) const { index.ForEachNameContaining(text, fn); }
 
-		return gameObjects;
+	// Calls fn(ObjectHandle) for every object that has all the components in mask
+	template <typename Fn>
+	void ForEachWithComponents(ComponentMask mask, Fn&& fn) const {
+		registry.EachWithMask(mask, [&](Entity entity) { fn(registry.GetObject(entity)->GetHandle()); });
 	}
 
-	// returns a vector of game objects with a name that contains a given sub-name
-	std::vector<std::shared_ptr<GameObject>> SearchByNameContains(const std::string& name) {
-		std::vector<std::shared_ptr<GameObject>> gameObjects;
+	// The Search functions below copy the results of the lookups above
 
-		for(const std::shared_ptr<GameObject>& model : models) {
-			if(model->name.find(name) != std::string::npos) {
-				gameObjects.push_back(model);
-			}
-		}
+	// returns the handles of the game objects containing specific tag
+	std::vector<ObjectHandle> SearchByTag(const std::string& tag) const {
+		const TagId id = index.FindTag(tag);
+		return id == kNoTag ? std::vector<ObjectHandle>() : index.FindByTag(id);
+	}
 
-		for(const std::shared_ptr<GameObject>& light : lights) {
-			if(light->name.find(name) != std::string::npos) {
-				gameObjects.push_back(light);
-			}
-		}
+	// returns the handles of the game objects containing specific component
+	std::vector<ObjectHandle> SearchByComponent(COMPONENT_TYPE type) const {
+		std::vector<ObjectHandle> gameObjects;
+		ForEachWithComponents(MaskOf(type), [&](ObjectHandle handle) { gameObjects.push_back(handle); });
+		return gameObjects;
+	}
+
+	// returns the handles of the game objects with specific name
+	std::vector<ObjectHandle> SearchByName(const std::string& name) const {
+		return index.FindByName(name);
+	}
 
+	// returns the handles of the game objects with a name that contains a given sub-name
+	std::vector<ObjectHandle> SearchByNameContains(const std::string& name) const {
+		std::vector<ObjectHandle> gameObjects;
+		ForEachNameContaining(name, [&](ObjectHandle handle) { gameObjects.push_back(handle); });
 		return gameObjects;
 	}
 
@@ -0,0 +1,172 @@
+#pragma once
+
+#include "game_object.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Interned tag; compare ids instead of strings
+using TagId = uint32_t;
+constexpr TagId kNoTag = UINT32_MAX;
+
+// Name and tag lookup tables of a Scene, kept up to date as objects are
+// created, renamed, tagged and destroyed. Every lookup is a hash probe or a
+// tree search, and none allocates.
+//   names     - name -> objects with exactly that name
+//   tags      - interned tag -> objects carrying it
+//   suffixes  - ordered suffixes of every distinct name, for substring search.
+//               A name that appears inserts its suffixes and one that
+//               disappears erases them, O(length * log suffixes) each;
+//               renaming to an existing name leaves them alone.
+class SceneIndex {
+public:
+    SceneIndex() : suffixes(SuffixLess{&names}) {}
+
+    // The suffix order refers to this index's names
+    SceneIndex(const SceneIndex&) = delete;
+    SceneIndex& operator=(const SceneIndex&) = delete;
+
+    // Registers a new object under `name`
+    void Add(ObjectHandle handle, const std::string& name);
+
+    // Drops the object's name and tags
+    void Remove(ObjectHandle handle);
+
+    void Rename(ObjectHandle handle, const std::string& name);
+
+    // Every object named exactly `name`, in no particular order
+    const std::vector<ObjectHandle>& FindByName(const std::string& name) const;
+
+    // Returns the tag's id, adding it on first use
+    TagId InternTag(const std::string& tag);
+
+    // kNoTag if no object was ever tagged with it
+    TagId FindTag(const std::string& tag) const;
+
+    const std::string& GetTagName(TagId tag) const { return tagNames[tag]; }
+
+    // False if the object already had / did not have the tag
+    bool AddTag(ObjectHandle handle, TagId tag);
+    bool RemoveTag(ObjectHandle handle, TagId tag);
+    bool HasTag(ObjectHandle handle, TagId tag) const;
+
+    // Every object carrying the tag, in no particular order
+    const std::vector<ObjectHandle>& FindByTag(TagId tag) const;
+
+    // Calls fn(ObjectHandle) once for every object whose name contains
+    // `text`, grouped by name. fn must not rename or destroy objects.
+    template <typename Fn>
+    void ForEachNameContaining(const std::string& text, Fn&& fn) const;
+
+private:
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    struct NameEntry {
+        std::string text;
+        std::vector<ObjectHandle> objects;
+    };
+
+    // Position of the object in a tag's member list
+    struct TagMembership {
+        TagId tag;
+        uint32_t position;
+    };
+
+    // Per object slot: where its handle is in the tables above
+    struct ObjectEntry {
+        uint32_t name = kNone;
+        uint32_t namePosition = 0;
+        std::vector<TagMembership> tags;
+    };
+
+    // A name's text from `offset` on
+    struct Suffix {
+        uint32_t name;
+        uint32_t offset;
+    };
+
+    // Orders suffixes by text, then by name and offset so equal suffixes of
+    // different names are all kept. A string_view compares with the first
+    // characters of a suffix, which finds every suffix starting with it.
+    struct SuffixLess {
+        using is_transparent = void;
+
+        const std::vector<NameEntry>* names;
+
+        std::string_view Text(const Suffix& s) const {
+            return std::string_view((*names)[s.name].text).substr(s.offset);
+        }
+
+        bool operator()(const Suffix& a, const Suffix& b) const {
+            const int order = Text(a).compare(Text(b));
+            return order != 0 ? order < 0 : std::tie(a.name, a.offset) < std::tie(b.name, b.offset);
+        }
+        bool operator()(const Suffix& s, std::string_view prefix) const {
+            return Text(s).substr(0, prefix.size()) < prefix;
+        }
+        bool operator()(std::string_view prefix, const Suffix& s) const {
+            return prefix < Text(s).substr(0, prefix.size());
+        }
+    };
+
+    using SuffixSet = std::set<Suffix, SuffixLess>;
+
+    void AddName(ObjectHandle handle, const std::string& name);
+    void RemoveName(ObjectHandle handle);
+
+    // Inserts or erases every suffix of a name while its text is set
+    void AddSuffixes(uint32_t name);
+    void RemoveSuffixes(uint32_t name);
+
+    // Marks the name as seen by the current search; false if it already was
+    bool Visit(uint32_t name) const;
+
+    std::unordered_map<std::string, uint32_t> nameIds;
+    std::vector<NameEntry> names;
+    std::vector<uint32_t> freeNames;
+
+    std::vector<ObjectEntry> objects;
+
+    std::unordered_map<std::string, TagId> tagIds;
+    std::vector<std::string> tagNames;
+    std::vector<std::vector<ObjectHandle>> tagMembers;
+
+    SuffixSet suffixes;
+
+    // Per name: the last search that reported it
+    mutable std::vector<uint32_t> nameStamps;
+    mutable uint32_t searchStamp = 0;
+};
+
+template <typename Fn>
+void SceneIndex::ForEachNameContaining(const std::string& text, Fn&& fn) const {
+    // A name containing text twice has two matching suffixes; report it once
+    ++searchStamp;
+    if (searchStamp == 0) {
+        std::fill(nameStamps.begin(), nameStamps.end(), 0);
+        searchStamp = 1;
+    }
+
+    if (text.empty()) {
+        // Every name contains it, even the empty one
+        for (uint32_t name = 0; name < names.size(); ++name) {
+            for (ObjectHandle handle : names[name].objects) fn(handle);
+        }
+        return;
+    }
+
+    // Suffixes starting with text are contiguous
+    const std::string_view prefix(text);
+    const auto end = suffixes.upper_bound(prefix);
+    for (auto it = suffixes.lower_bound(prefix); it != end; ++it) {
+        if (!Visit(it->name)) continue;
+        for (ObjectHandle handle : names[it->name].objects) fn(handle);
+    }
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Weak reference to an object in a SlotMap. Erasing the object bumps its
+// slot's generation, so old handles resolve to nullptr even after the slot
+// is reused. A default constructed handle refers to nothing.
+struct SlotHandle {
+    static constexpr uint32_t kNoIndex = UINT32_MAX;
+
+    uint32_t index = kNoIndex;
+    uint32_t generation = 0;
+
+    bool operator==(const SlotHandle& other) const {
+        return index == other.index && generation == other.generation;
+    }
+    bool operator!=(const SlotHandle& other) const { return !(*this == other); }
+};
+
+// Objects stored in place in fixed-size pages, so they never move and create
+// or destroy does not touch the heap once the pages exist. Erased slots go on
+// a free list and are reused first. Create, destroy and lookup are O(1).
+template <typename T, size_t PageSize = 256>
+class SlotMap {
+public:
+    SlotMap() = default;
+    SlotMap(const SlotMap&) = delete;
+    SlotMap& operator=(const SlotMap&) = delete;
+
+    ~SlotMap() { Clear(); }
+
+    template <typename... Args>
+    SlotHandle Emplace(Args&&... args) {
+        if (freeHead == kNone) {
+            if (slotCount % PageSize == 0) {
+                pages.push_back(std::make_unique<Slot[]>(PageSize));
+            }
+            freeHead = slotCount++;
+        }
+
+        // Taken off the free list only once constructed, so a throwing
+        // constructor loses nothing
+        const uint32_t index = freeHead;
+        Slot& slot = At(index);
+        new (slot.storage) T(std::forward<Args>(args)...);
+        freeHead = slot.nextFree;
+        slot.alive = true;
+        ++size;
+
+        return {index, slot.generation};
+    }
+
+    // Destroys the object; false if the handle was already stale
+    bool Erase(SlotHandle handle) {
+        if (!Get(handle)) return false;
+
+        Slot& slot = At(handle.index);
+        slot.Object()->~T();
+        slot.alive = false;
+        ++slot.generation;
+        slot.nextFree = freeHead;
+        freeHead = handle.index;
+        --size;
+        return true;
+    }
+
+    // nullptr if the handle is stale or refers to nothing
+    T* Get(SlotHandle handle) const {
+        if (handle.index >= slotCount) return nullptr;
+
+        Slot& slot = At(handle.index);
+        return slot.alive && slot.generation == handle.generation ? slot.Object() : nullptr;
+    }
+
+    // Destroys every object; the pages are kept for reuse
+    void Clear() {
+        for (uint32_t i = 0; i < slotCount; ++i) {
+            Slot& slot = At(i);
+            if (slot.alive) Erase({i, slot.generation});
+        }
+    }
+
+    size_t Size() const { return size; }
+
+    // Slots ever used, alive or free
+    size_t Capacity() const { return slotCount; }
+
+private:
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    struct Slot {
+        alignas(T) unsigned char storage[sizeof(T)];
+        uint32_t generation = 0;
+        uint32_t nextFree = kNone;
+        bool alive = false;
+
+        T* Object() { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+    Slot& At(uint32_t index) const { return pages[index / PageSize][index % PageSize]; }
+
+    std::vector<std::unique_ptr<Slot[]>> pages;
+    uint32_t slotCount = 0;
+    uint32_t freeHead = kNone;
+    size_t size = 0;
+};
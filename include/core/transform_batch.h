@@ -0,0 +1,43 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <vector>
+
+// A matrix and its inverse transpose (for normals), back to back: the layout
+// of the renderer's per-instance attributes, so an array of these can be
+// uploaded as is.
+struct TransformMatrices {
+    glm::mat4 matrix;
+    glm::mat4 inverseTranspose;
+};
+
+// Position, Euler rotation (degrees) and scale of many transforms in SoA
+// form, the layout ComposeTransforms reads. Arrays are padded with identity
+// transforms to a multiple of kLanes.
+class TrsList {
+public:
+    static constexpr size_t kLanes = 8;
+
+    std::vector<float> px, py, pz;
+    std::vector<float> rx, ry, rz;
+    std::vector<float> sx, sy, sz;
+
+    void Clear();
+
+    void Add(const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale);
+
+    size_t Size() const { return count; }
+    size_t PaddedSize() const { return px.size(); }
+
+private:
+    size_t count = 0;
+};
+
+// matrices[i] = translate * rotX * rotY * rotZ * scale of entry i (as in
+// Transform::ComputeLocalMatrix) and its inverse transpose, 4 or 8 entries at
+// a time on the widest instruction set the CPU supports. The inverse comes
+// in closed form, R * S^-1 plus the translation term, so a zero scale gives
+// non-finite normals just like glm::inverse would. `matrices` holds Size()
+// entries.
+void ComposeTransforms(const TrsList& list, TransformMatrices* matrices);
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "game_object.h"
+#include "transform_batch.h"
+
+#include <cstdint>
+#include <vector>
+
+// Parent/child links between the objects of a Scene, and the pass that
+// brings every Transform's cached matrices up to date:
+//   world = parent world * local
+// Transforms are visited parents first. A transform's matrices are only
+// rebuilt when it is dirty or its parent's world matrix changed this pass,
+// so objects that did not move cost a flag test. Local matrices are built by
+// ComposeTransforms, 4 or 8 dirty transforms at a time.
+class TransformHierarchy {
+public:
+    // Makes child a child of parent; an invalid parent handle makes it a
+    // root. False if parent is child or one of its descendants. Callers pass
+    // live handles only.
+    bool SetParent(ObjectHandle child, ObjectHandle parent);
+
+    // Invalid handle for roots
+    ObjectHandle GetParent(ObjectHandle handle) const;
+
+    const std::vector<ObjectHandle>& GetChildren(ObjectHandle handle) const;
+
+    // Unlinks a destroyed object; its children become roots
+    void Remove(ObjectHandle handle);
+
+    // Rebuilds the matrices of dirty transforms and their descendants
+    void Update(ComponentRegistry& registry);
+
+private:
+    struct Node {
+        ObjectHandle parent;
+        std::vector<ObjectHandle> children;
+    };
+
+    // Recomputes the transform's world matrices from its parent's
+    static void UpdateWorld(Transform& transform, const Transform& parent);
+
+    // Sorts the objects that have a parent by depth
+    void BuildOrder();
+
+    Node& NodeOf(ObjectHandle handle);
+
+    std::vector<Node> nodes;
+
+    // Every object with a parent, parents before children
+    std::vector<Entity> order;
+    bool orderDirty = false;
+
+    // Objects given a new parent since the last Update
+    std::vector<Entity> relinked;
+
+    // Per entity: did the world matrix change in the current Update
+    std::vector<uint8_t> changed;
+
+    // This Update's dirty transforms, their SoA inputs and the batch output
+    TrsList dirtyTrs;
+    std::vector<Transform*> dirtyTransforms;
+    std::vector<TransformMatrices> dirtyMatrices;
+};
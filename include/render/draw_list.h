@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Passes in the order they are drawn each frame
+enum class RenderPass : uint32_t {
+    Shadow = 0,
+    Main = 1
+};
+
+// 64 bit sort key of a draw item, most significant field first:
+//   pass (2) | program (4) | mesh (20) | material (20) | unique (18)
+// Items with equal keys are drawn as one instanced batch. `unique` keeps
+// items apart that must not be batched (soft bodies); 0 for everything else.
+namespace DrawKey {
+    constexpr uint32_t kProgramBits = 4;
+    constexpr uint32_t kMeshBits = 20;
+    constexpr uint32_t kMaterialBits = 20;
+    constexpr uint32_t kUniqueBits = 18;
+
+    // Largest `unique` value; callers with more items to keep apart wrap
+    // around to 1, never to 0
+    constexpr uint32_t kMaxUnique = (uint32_t(1) << kUniqueBits) - 1;
+
+    constexpr uint32_t kUniqueShift = 0;
+    constexpr uint32_t kMaterialShift = kUniqueShift + kUniqueBits;
+    constexpr uint32_t kMeshShift = kMaterialShift + kMaterialBits;
+    constexpr uint32_t kProgramShift = kMeshShift + kMeshBits;
+    constexpr uint32_t kPassShift = kProgramShift + kProgramBits;
+
+    constexpr uint64_t Field(uint64_t key, uint32_t shift, uint32_t bits) {
+        return (key >> shift) & ((uint64_t(1) << bits) - 1);
+    }
+
+    // Values wider than their field are truncated
+    constexpr uint64_t Make(RenderPass pass, uint32_t program, uint32_t mesh, uint32_t material, uint32_t unique = 0) {
+        return uint64_t(pass) << kPassShift
+             | Field(program, 0, kProgramBits) << kProgramShift
+             | Field(mesh, 0, kMeshBits) << kMeshShift
+             | Field(material, 0, kMaterialBits) << kMaterialShift
+             | Field(unique, 0, kUniqueBits) << kUniqueShift;
+    }
+
+    constexpr RenderPass PassOf(uint64_t key) { return RenderPass(key >> kPassShift); }
+    constexpr uint32_t ProgramOf(uint64_t key) { return uint32_t(Field(key, kProgramShift, kProgramBits)); }
+    constexpr uint32_t MeshOf(uint64_t key) { return uint32_t(Field(key, kMeshShift, kMeshBits)); }
+    constexpr uint32_t MaterialOf(uint64_t key) { return uint32_t(Field(key, kMaterialShift, kMaterialBits)); }
+}
+
+struct DrawItem {
+    uint64_t key;
+    uint32_t object;   // caller's index of the object, e.g. into its matrices
+    uint32_t pad;
+};
+
+// Per-frame list of everything to draw, in every pass. Gather with Add,
+// Sort once, then Submit each pass. Knows nothing about GL: the ids in the
+// key are whatever the backend gives them meaning.
+class DrawList {
+public:
+    void Clear() { items.clear(); }
+    void Reserve(size_t count) { items.reserve(count); }
+
+    void Add(uint64_t key, uint32_t object) { items.push_back({key, object, 0}); }
+
+    // Stable LSD radix sort by key; items with equal keys keep the order
+    // they were added in
+    void Sort();
+
+    // Sorted after Sort(); item i is instance i of the frame's instance data
+    const std::vector<DrawItem>& GetItems() const { return items; }
+    size_t Size() const { return items.size(); }
+
+    // [begin, end) of the pass's items; requires Sort()
+    std::pair<size_t, size_t> PassRange(RenderPass pass) const;
+
+    // Walks the pass's items and calls, only when the value changes:
+    //   backend.BindProgram(uint32_t program)
+    //   backend.BindMesh(uint32_t mesh)
+    //   backend.BindMaterial(uint32_t material)   (again after a program change)
+    // then backend.Draw(size_t firstItem, size_t count) once per run of equal keys.
+    template <typename Backend>
+    void Submit(RenderPass pass, Backend& backend) const;
+
+private:
+    std::vector<DrawItem> items;
+    std::vector<DrawItem> scratch;
+};
+
+template <typename Backend>
+void DrawList::Submit(RenderPass pass, Backend& backend) const {
+    constexpr uint32_t kNone = UINT32_MAX;
+    uint32_t program = kNone, mesh = kNone, material = kNone;
+
+    const auto [begin, end] = PassRange(pass);
+    for (size_t i = begin; i < end;) {
+        const uint64_t key = items[i].key;
+        size_t j = i + 1;
+        while (j < end && items[j].key == key) ++j;
+
+        if (DrawKey::ProgramOf(key) != program) {
+            program = DrawKey::ProgramOf(key);
+            backend.BindProgram(program);
+            // Material uniforms belong to the program
+            material = kNone;
+        }
+        if (DrawKey::MeshOf(key) != mesh) {
+            mesh = DrawKey::MeshOf(key);
+            backend.BindMesh(mesh);
+        }
+        if (DrawKey::MaterialOf(key) != material) {
+            material = DrawKey::MaterialOf(key);
+            backend.BindMaterial(material);
+        }
+
+        backend.Draw(i, j - i);
+        i = j;
+    }
+}
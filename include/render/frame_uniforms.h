@@ -0,0 +1,32 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+
+// Must match NUM_LIGHTS in the shaders
+constexpr int kMaxLights = 10;
+
+// Uniform buffer binding point of the FrameData block
+constexpr unsigned int kFrameDataBinding = 0;
+
+// std140 mirror of the FrameData uniform block declared in the shaders.
+// vec3 members take 16 bytes there, hence the padding.
+struct FrameLight {
+    glm::vec3 position;
+    float pad0;
+    glm::vec3 color;
+    float pad1;
+};
+
+struct FrameUniforms {
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::mat4 lightSpaceMatrix;
+    glm::vec3 lightPosition;
+    float pad0;
+    FrameLight lights[kMaxLights];
+};
+
+static_assert(offsetof(FrameUniforms, lightPosition) == 192, "FrameData layout");
+static_assert(offsetof(FrameUniforms, lights) == 208, "FrameData layout");
+static_assert(sizeof(FrameLight) == 32, "FrameData layout");
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Six planes (left, right, bottom, top, near, far) with normals pointing
+// inwards: a point p is inside plane i when dot(xyz, p) + w >= 0.
+struct Frustum {
+    glm::vec4 planes[6];
+
+    // Planes of the clip volume of a projection * view matrix, in the space
+    // the view matrix maps from (world space for the camera and the light)
+    static Frustum FromMatrix(const glm::mat4& clip);
+};
+
+// World space boxes in SoA form (center and half extent per axis), the
+// layout the culling kernel reads. Arrays are padded with empty boxes to a
+// multiple of kLanes.
+class AabbList {
+public:
+    static constexpr size_t kLanes = 8;
+
+    std::vector<float> cx, cy, cz;
+    std::vector<float> ex, ey, ez;
+
+    void Clear();
+
+    // Adds the world bounds of a model space box under `model`
+    void Add(const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::mat4& model);
+
+    size_t Size() const { return count; }
+    size_t PaddedSize() const { return cx.size(); }
+
+private:
+    size_t count = 0;
+};
+
+// visible[i] = 1 if box i is inside or intersects the frustum, 0 if it is
+// entirely outside one of the planes. Conservative: a box near a corner may
+// be reported visible when it is not.
+void CullAabbs(const Frustum& frustum, const AabbList& boxes, std::vector<uint8_t>& visible);
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <glad\glad.h>
+#include <glm/glm.hpp>
+
+// GL objects of one uploaded mesh. The renderer keeps these in a table
+// indexed by the mesh's MeshHandle; vao == 0 means not uploaded yet.
+struct GpuMesh {
+    GLuint vao = 0;
+    GLuint posVBO = 0;
+    GLuint norVBO = 0;
+    GLuint texVBO = 0;
+    GLuint ebo = 0;
+
+    GLsizei indexCount = 0;
+    GLenum indexType = GL_UNSIGNED_INT;
+
+    // Model space bounds, for culling
+    glm::vec3 boundsMin = glm::vec3(0.0f);
+    glm::vec3 boundsMax = glm::vec3(0.0f);
+
+    // Offset applied by Transform::GetModelMatrix
+    glm::vec3 bias = glm::vec3(0.0f);
+
+    // Set once the mesh was requested, so a broken file is not retried
+    bool requested = false;
+
+    bool IsUploaded() const { return vao != 0; }
+};
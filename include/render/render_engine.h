@@ -1,8 +1,14 @@
 #pragma once
 
 #include "shader.h"
+#include "gpu_mesh.h"
+#include "frame_uniforms.h"
+#include "draw_list.h"
+#include "frustum.h"
+#include "soft_body_buffers.h"
 #include "core/camera.h"
 #include "core/main_engine.h"
+#include "core/assets/mesh_handle.h"
 
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
@@ -11,6 +17,8 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <deque>
+#include <array>
 #include <unordered_map>
 
 #define NUM_LIGHTS 2
@@ -35,14 +43,89 @@ class RenderEngine
 
 	Shader program;
 	Shader shadow;
-	std::unordered_map<std::string, GLuint> posBuffMap;
-	std::unordered_map<std::string, GLuint> norBuffMap;
-	std::unordered_map<std::string, GLuint> texBuffMap;
-	std::unordered_map<std::string, GLuint> indexBuffMap;
-	std::unordered_map<std::string, size_t> indexCountMap;
-	std::unordered_map<std::string, GLuint> vaoMap;
 
-    std::unordered_map<std::string, glm::vec3>          biasMap;
+	// Camera and lights, written once per frame by BeginFrame and read by
+	// both programs through the FrameData block
+	GLuint frameUBO = 0;
+	FrameUniforms frameUniforms;
+
+	struct MaterialKeyHash {
+		size_t operator()(const std::array<float, 10>& key) const {
+			size_t hash = 0;
+			for (float value : key) hash = hash * 31 + std::hash<float>()(value);
+			return hash;
+		}
+	};
+
+	// Per-draw uniforms, looked up once in ShadersInit
+	struct {
+		GLint ka, kd, ks, s;
+		GLint shadowMap;
+	} phongLocations;
+
+	// Per-instance vertex attributes, read by both programs
+	struct InstanceData {
+		glm::mat4 model;
+		glm::mat4 modelInverseTranspose;
+	};
+
+	// Program ids used in draw keys
+	enum : uint32_t { kPhongProgram = 0, kShadowProgram = 1 };
+
+	// Both passes' draws, built and sorted once per frame by BeginFrame
+	DrawList drawList;
+
+	// What an object contributes to the draw keys
+	struct ObjectDraw {
+		MeshHandle mesh;
+		uint32_t material;
+		uint32_t unique;
+	};
+
+	// Per-frame tables indexed by DrawItem::object
+	std::vector<InstanceData> objectInstances;
+	std::vector<Entity> objectEntities;
+	std::vector<const SoftBody*> objectSoftBodies;
+	std::vector<ObjectDraw> objectDraws;
+
+	// Where each soft body's positions are this frame (buffer 0 for rigid
+	// objects, which use their mesh's positions)
+	std::vector<SoftBodyBuffers::Binding> objectPositions;
+	SoftBodyBuffers softBodyBuffers;
+
+	// The scene softBodyBuffers holds entities of
+	const Scene* softBodyScene = nullptr;
+
+	// World bounds of the objects and which frusta they are in
+	AabbList objectBounds;
+	std::vector<uint8_t> visibleToCamera;
+	std::vector<uint8_t> visibleToLight;
+
+	// The frame's distinct materials, indexed by the key's material field
+	std::vector<const Material*> frameMaterials;
+	std::unordered_map<std::array<float, 10>, uint32_t, MaterialKeyHash> materialIds;
+
+	// objectInstances in draw list order; item i is instance i
+	std::vector<InstanceData> instances;
+
+	GLuint instanceVBO = 0;
+	size_t instanceCapacity = 0;
+
+	// Gathers the scene's models, culls them against the camera and the
+	// light, and uploads the matrices of what is left
+	void BuildDrawList(Scene& scene);
+
+	// Points the bound VAO's instance attributes at instances[firstInstance...]
+	void BindInstances(GLint firstInstance);
+
+	// Runs a DrawList pass on GL
+	struct DrawBackend;
+	// GPU copy of every mesh, indexed by its AssetRegistry MeshHandle
+	std::vector<GpuMesh> gpuMeshes;
+
+	// Meshes loading on a background job, uploaded by UploadPendingModels
+	// once ready
+	std::deque<MeshHandle> pendingMeshes;
 
 	std::vector<float> posBuff;
 	std::vector<float> norBuff;
@@ -85,12 +168,29 @@ public:
 
 	void ShadersInit();
 
+	// Updates the per-frame uniform buffer; call before MapShadows and Display
+	void BeginFrame(glm::vec4 viewportInfo);
+
+	// Fences the frame for the soft body buffers; call after Display
+	void EndFrame();
+
 	void MapShadows(GLuint depthMapFBO, GLuint shadowWidth = 1024,  GLuint shadowHeight = 1024);
 
 	void Display(glm::vec4 viewportInfo, GLuint depthMap);
 	void CharacterCallback(GLFWwindow* window, unsigned int key);
 	void FrameBufferSizeCallback(GLFWwindow* lWindow, int width, int height);
 
-	void LoadModel(const std::string &name);
+	// Creates the GL buffers of a loaded mesh
+	void UploadMesh(MeshHandle handle);
+
+	// The model's GPU mesh once uploaded. Otherwise starts loading it in the
+	// background (once) and returns nullptr; the caller skips the model this frame.
+	const GpuMesh* RequestModel(Model &model);
+
+	// Creates GL buffers for models whose background load finished, at most
+	// about uploadBudgetBytes per call. Call once per frame on the GL thread.
+	void UploadPendingModels();
+
+	size_t uploadBudgetBytes = 16 * 1024 * 1024;
 
 };
\ No newline at end of file
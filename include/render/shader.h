@@ -23,12 +23,29 @@ public:
     void SendUniformData(float a, const char* name);
     void SendUniformData(glm::vec3 input, const char* name);
     void SendUniformData(glm::mat4 &mat, const char* name);
+
+    // Same as above with a location from GetUniformLocation, for per-draw data
+    void SendUniformData(int a, GLint location);
+    void SendUniformData(float a, GLint location);
+    void SendUniformData(glm::vec3 input, GLint location);
+    void SendUniformData(const glm::mat4 &mat, GLint location);
+
+    // Looked up in the table built at link time; -1 if the program has no
+    // such uniform (glUniform* then ignores the call, as GL does)
+    GLint GetUniformLocation(const char* name) const;
+
+    // Attaches the named uniform block to a GL_UNIFORM_BUFFER binding point
+    void BindUniformBlock(const char* name, GLuint binding);
     void Bind();
     void Unbind();
     GLint GetPID() { return programID; }
 
 private:
+    // Fills uniformLocations with every active uniform of the linked program
+    void CacheUniformLocations();
+
     GLint programID;
     std::string vertexShaderFileName, fragmentShaderFileName;
     std::unordered_map<std::string, GLuint> bufferMap;
+    std::unordered_map<std::string, GLint> uniformLocations;
 };
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <glad\glad.h>
+#include "core/component_registry.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+class SoftBody;
+
+// Per soft body position buffers, so bodies sharing a mesh no longer write
+// over each other (or over the mesh's rest positions). Every body gets its
+// own buffer with kFrames slots, kept under its entity since the body itself
+// moves whenever its pool grows or shrinks; a moved body is written to the next slot
+// while the GPU may still read the previous ones, and a body whose
+// positions did not change since its last upload is not uploaded at all.
+//
+// With GL 4.4 / ARB_buffer_storage the buffers are persistently mapped and
+// written directly; a fence per frame keeps the CPU kFrames - 1 frames
+// ahead at most. Otherwise each slot is filled with glBufferSubData.
+class SoftBodyBuffers {
+public:
+    static constexpr int kFrames = 3;
+
+    // Where a body's current positions are, for glVertexAttribPointer
+    struct Binding {
+        GLuint buffer = 0;
+        GLintptr offset = 0;
+    };
+
+    SoftBodyBuffers();
+    ~SoftBodyBuffers();
+
+    SoftBodyBuffers(const SoftBodyBuffers&) = delete;
+    SoftBodyBuffers& operator=(const SoftBodyBuffers&) = delete;
+
+    // Waits until the GPU is done with the frame kFrames ago and frees the
+    // buffers of bodies that have not been drawn for a while
+    void BeginFrame();
+
+    // Uploads the positions of the entity's body if they changed; call for
+    // drawn bodies only
+    Binding Update(Entity entity, const SoftBody& body);
+
+    // Frees the entity's buffer; call once its body is removed
+    void Release(Entity entity);
+
+    // Frees every buffer, e.g. when another scene is drawn
+    void Clear();
+
+    // Fences the frame's draws; call after the last pass
+    void EndFrame();
+
+    bool IsPersistent() const { return persistent; }
+
+private:
+    struct Entry {
+        GLuint buffer = 0;
+        void* mapped = nullptr;
+        size_t slotBytes = 0;
+        int slot = 0;
+        uint64_t version = 0;
+        uint64_t lastUsedFrame = 0;
+    };
+
+    void Release(Entry& entry);
+
+    // An entity given a new body in place of its old one is caught by the
+    // body's different positions version
+    std::unordered_map<Entity, Entry> entries;
+
+    GLsync fences[kFrames] = {};
+    uint64_t frame = 0;
+    bool persistent = false;
+};
@@ -1,13 +1,6 @@
 #version 330 core
 
-uniform mat4 modelMatrix;
-uniform mat4 viewMatrix;
-uniform mat4 projectionMatrix;
-uniform mat4 modelInverseTranspose;
-uniform mat4 lightSpaceMatrix;
-uniform vec3 lightPosition;
-
-uniform sampler2D shadowMap;
+#define NUM_LIGHTS 10
 
 struct Light
 {
@@ -15,9 +8,17 @@ struct Light
     vec3 color;
 };
 
-#define NUM_LIGHTS 10
+// Per-frame data, filled once per frame by the renderer (see frame_uniforms.h)
+layout (std140) uniform FrameData
+{
+    mat4 view;
+    mat4 projection;
+    mat4 lightSpaceMatrix;
+    vec3 lightPosition;
+    Light lights[NUM_LIGHTS];
+};
 
-uniform Light lights[NUM_LIGHTS];
+uniform sampler2D shadowMap;
 
 uniform vec3 ka;
 uniform vec3 kd;
@@ -65,7 +66,7 @@ void main()
         vec3 reflectDir = reflect(-lightDir, normal);
 
         // Transform the fragment position to view space
-        vec4 viewPosition = vec4(viewMatrix * vec4(fragPosition, 1.0));
+        vec4 viewPosition = vec4(view * vec4(fragPosition, 1.0));
 
         // Calculate the view vector
         vec3 viewDir = normalize(-viewPosition.xyz); // From camera to fragment
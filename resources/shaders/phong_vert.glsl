@@ -4,12 +4,27 @@ layout (location = 0) in vec3 vPositionModel; // in object space
 layout (location = 1) in vec3 vNormalModel;   // in object space
 layout (location = 2) in vec2 vTexCoord;
 
+#define NUM_LIGHTS 10
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
-uniform mat4 modelInverseTranspose;
-uniform mat4 lightSpaceMatrix;
+struct Light
+{
+    vec3 position;
+    vec3 color;
+};
+
+// Per-frame data, filled once per frame by the renderer (see frame_uniforms.h)
+layout (std140) uniform FrameData
+{
+    mat4 view;
+    mat4 projection;
+    mat4 lightSpaceMatrix;
+    vec3 lightPosition;
+    Light lights[NUM_LIGHTS];
+};
+
+// Per instance, from the renderer's instance buffer
+layout (location = 3) in mat4 model;
+layout (location = 7) in mat4 modelInverseTranspose;
 
 out vec3 fragPosition;
 out vec3 fragNormal;
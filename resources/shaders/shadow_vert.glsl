@@ -1,8 +1,26 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
 
-uniform mat4 lightSpaceMatrix;
-uniform mat4 model;
+#define NUM_LIGHTS 10
+
+struct Light
+{
+    vec3 position;
+    vec3 color;
+};
+
+// Per-frame data, filled once per frame by the renderer (see frame_uniforms.h)
+layout (std140) uniform FrameData
+{
+    mat4 view;
+    mat4 projection;
+    mat4 lightSpaceMatrix;
+    vec3 lightPosition;
+    Light lights[NUM_LIGHTS];
+};
+
+// Per instance, from the renderer's instance buffer
+layout (location = 3) in mat4 model;
 
 void main()
 {
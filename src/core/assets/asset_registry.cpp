@@ -0,0 +1,150 @@
+#include "core/assets/asset_registry.h"
+
+#include "core/job_system.h"
+#include "core/physics/softbody_topology.h"
+
+#include <iostream>
+#include <stdexcept>
+
+AssetRegistry& AssetRegistry::Instance() {
+    static AssetRegistry registry;
+    return registry;
+}
+
+AssetRegistry::MeshEntry& AssetRegistry::Entry(MeshHandle handle) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (handle >= meshes.size()) {
+        throw std::out_of_range("Invalid mesh handle");
+    }
+    return *meshes[handle];
+}
+
+template <typename Build>
+void AssetRegistry::BuildView(MeshEntry& entry, AssetState& state, Build&& build) {
+    std::unique_lock<std::mutex> lock(entry.mutex);
+    entry.built.wait(lock, [&] { return state != AssetState::Loading; });
+    if (state == AssetState::Ready) return;
+
+    // Outside the lock so other views, and the mesh's state, stay readable
+    state = AssetState::Loading;
+    lock.unlock();
+    try {
+        build();
+    } catch (...) {
+        lock.lock();
+        state = AssetState::Failed;
+        entry.built.notify_all();
+        throw;
+    }
+
+    lock.lock();
+    state = AssetState::Ready;
+    entry.built.notify_all();
+}
+
+MeshHandle AssetRegistry::Register(const std::string& path, MeshEntry*& entry) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = handles.find(path);
+    if (it == handles.end()) {
+        it = handles.emplace(path, static_cast<MeshHandle>(meshes.size())).first;
+        meshes.push_back(std::make_unique<MeshEntry>());
+        meshes.back()->path = path;
+    }
+
+    entry = meshes[it->second].get();
+    return it->second;
+}
+
+MeshHandle AssetRegistry::LoadMesh(const std::string& path, JobSystem* jobs) {
+    MeshEntry* entry;
+    const MeshHandle handle = Register(path, entry);
+
+    // Outside the registry lock so different meshes load in parallel; a
+    // second caller for the same mesh waits for the first. A failed load is
+    // retried next time.
+    try {
+        BuildView(*entry, entry->renderState, [&] {
+            entry->render = MeshData::Load(path, jobs);
+        });
+    } catch (...) {
+        entry->state = AssetState::Failed;
+        throw;
+    }
+
+    entry->state = AssetState::Ready;
+    return handle;
+}
+
+MeshHandle AssetRegistry::RequestMesh(const std::string& path, JobSystem& jobs) {
+    MeshEntry* entry;
+    const MeshHandle handle = Register(path, entry);
+
+    AssetState expected = AssetState::Unloaded;
+    if (!entry->state.compare_exchange_strong(expected, AssetState::Loading)) {
+        return handle;
+    }
+
+    // Parses on whichever system ends up running the job, which is not
+    // `jobs` once MainEngine::SetThreadCount has moved it
+    jobs.SubmitBackground([this, path] {
+        // Jobs must not throw; LoadMesh has already marked the mesh Failed
+        try {
+            LoadMesh(path, JobSystem::Current());
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+        }
+    });
+
+    return handle;
+}
+
+MeshHandle AssetRegistry::FindMesh(const std::string& path) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = handles.find(path);
+    return it == handles.end() ? kInvalidMesh : it->second;
+}
+
+AssetState AssetRegistry::GetMeshState(MeshHandle handle) const {
+    return Entry(handle).state.load();
+}
+
+const std::string& AssetRegistry::GetPath(MeshHandle handle) const {
+    return Entry(handle).path;
+}
+
+const MeshData& AssetRegistry::GetRenderMesh(MeshHandle handle) const {
+    MeshEntry& entry = Entry(handle);
+
+    // A Ready view is never built again, so it can be read without the lock
+    std::lock_guard<std::mutex> lock(entry.mutex);
+    if (entry.renderState != AssetState::Ready) {
+        throw std::runtime_error("Mesh is not loaded: " + entry.path);
+    }
+    return *entry.render;
+}
+
+const WeldedMesh& AssetRegistry::GetWeldedMesh(MeshHandle handle) {
+    MeshEntry& entry = Entry(handle);
+    const MeshData& render = GetRenderMesh(handle);
+
+    BuildView(entry, entry.weldedState, [&] {
+        entry.welded = WeldedMesh::Build(render);
+    });
+    return entry.welded;
+}
+
+std::shared_ptr<const SoftBodyTopology> AssetRegistry::GetTopology(MeshHandle handle) {
+    MeshEntry& entry = Entry(handle);
+    const WeldedMesh& welded = GetWeldedMesh(handle);
+
+    BuildView(entry, entry.topologyState, [&] {
+        entry.topology = SoftBodyTopology::Build(entry.path, welded);
+    });
+    return entry.topology;
+}
+
+size_t AssetRegistry::GetMeshCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return meshes.size();
+}
@@ -0,0 +1,270 @@
+#include "core/assets/mesh_data.h"
+
+#include "core/assets/obj_parser.h"
+
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+    // What the cache remembers about its OBJ
+    struct SourceInfo {
+        uint64_t size = 0;
+        int64_t time = 0;
+    };
+
+    bool StatSource(const std::string& path, SourceInfo& info) {
+        std::error_code error;
+        info.size = std::filesystem::file_size(path, error);
+        if (error) return false;
+
+        const auto time = std::filesystem::last_write_time(path, error);
+        if (error) return false;
+
+        info.time = static_cast<int64_t>(time.time_since_epoch().count());
+        return true;
+    }
+
+    // 64 bit FNV-1a over the whole OBJ
+    uint64_t HashFile(const std::string& path) {
+        MappedFile file;
+        if (!file.Open(path)) return 0;
+
+        uint64_t hash = 0xcbf29ce484222325ull;
+        for (size_t i = 0; i < file.Size(); ++i) {
+            hash = (hash ^ file.Data()[i]) * 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    uint64_t AlignUp(uint64_t offset) {
+        return (offset + 15) & ~uint64_t(15);
+    }
+
+    bool IsValidImage(const uint8_t* data, size_t size) {
+        if (!data || size < sizeof(MeshCacheHeader)) return false;
+
+        const auto& h = *reinterpret_cast<const MeshCacheHeader*>(data);
+        if (h.magic != MeshCacheHeader::kMagic || h.version != MeshCacheHeader::kVersion) return false;
+        if (h.fileSize != size || (h.indexSize != 2 && h.indexSize != 4)) return false;
+
+        auto fits = [&](uint64_t offset, uint64_t bytes) {
+            return offset % 16 == 0 && offset <= size && bytes <= size - offset;
+        };
+        return fits(h.positionsOffset, uint64_t(h.vertexCount) * sizeof(glm::vec3)) &&
+               fits(h.normalsOffset, uint64_t(h.vertexCount) * sizeof(glm::vec3)) &&
+               fits(h.texCoordsOffset, uint64_t(h.vertexCount) * sizeof(glm::vec2)) &&
+               fits(h.indicesOffset, uint64_t(h.indexCount) * h.indexSize);
+    }
+
+    // Parses the OBJ and lays the welded mesh out exactly as the cache file stores it
+    std::vector<uint8_t> BuildImage(const std::string& objPath, const SourceInfo& source, JobSystem* jobs) {
+        tinyobj::attrib_t attrib;
+        std::vector<tinyobj::shape_t> shapes;
+        std::string err;
+
+        if (!ParseObj(objPath, attrib, shapes, err, jobs)) {
+            std::cerr << "OBJ error: " << err << std::endl;
+            throw std::runtime_error("Failed to load OBJ: " + objPath);
+        }
+
+        // Map unique vertex combination to index
+        struct Vertex {
+            int posIdx, normIdx, texIdx;
+
+            bool operator==(const Vertex &other) const {
+                return posIdx == other.posIdx &&
+                       normIdx == other.normIdx &&
+                       texIdx == other.texIdx;
+            }
+        };
+
+        struct VertexHash {
+            size_t operator()(const Vertex &v) const {
+                return std::hash<int>()(v.posIdx) ^
+                       std::hash<int>()(v.normIdx << 1) ^
+                       std::hash<int>()(v.texIdx << 2);
+            }
+        };
+
+        std::unordered_map<Vertex, uint32_t, VertexHash> uniqueVertices;
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec3> normals;
+        std::vector<glm::vec2> texCoords;
+        std::vector<uint32_t> indices;
+
+        for (const auto &shape: shapes) {
+            for (const tinyobj::index_t &idx : shape.mesh.indices) {
+                Vertex v{idx.vertex_index, idx.normal_index, idx.texcoord_index};
+
+                auto it = uniqueVertices.find(v);
+                if (it != uniqueVertices.end()) {
+                    indices.push_back(it->second);
+                    continue;
+                }
+
+                glm::vec3 pos(0.0f);
+                glm::vec3 norm(0.0f);
+                glm::vec2 tex(0.0f);
+
+                if (v.posIdx >= 0) {
+                    pos = {attrib.vertices[3 * v.posIdx + 0],
+                           attrib.vertices[3 * v.posIdx + 1],
+                           attrib.vertices[3 * v.posIdx + 2]};
+                }
+                if (v.normIdx >= 0) {
+                    norm = {attrib.normals[3 * v.normIdx + 0],
+                            attrib.normals[3 * v.normIdx + 1],
+                            attrib.normals[3 * v.normIdx + 2]};
+                }
+                if (v.texIdx >= 0) {
+                    tex = {attrib.texcoords[2 * v.texIdx + 0],
+                           attrib.texcoords[2 * v.texIdx + 1]};
+                }
+
+                const uint32_t newIndex = static_cast<uint32_t>(positions.size());
+                positions.push_back(pos);
+                normals.push_back(norm);
+                texCoords.push_back(tex);
+                indices.push_back(newIndex);
+
+                uniqueVertices[v] = newIndex;
+            }
+        }
+
+        MeshCacheHeader header{};
+        header.magic = MeshCacheHeader::kMagic;
+        header.version = MeshCacheHeader::kVersion;
+        header.sourceSize = source.size;
+        header.sourceTime = source.time;
+        header.sourceHash = HashFile(objPath);
+        header.vertexCount = static_cast<uint32_t>(positions.size());
+        header.indexCount = static_cast<uint32_t>(indices.size());
+        header.indexSize = positions.size() <= std::numeric_limits<uint16_t>::max() + 1u ? 2 : 4;
+
+        header.positionsOffset = AlignUp(sizeof(MeshCacheHeader));
+        header.normalsOffset = AlignUp(header.positionsOffset + positions.size() * sizeof(glm::vec3));
+        header.texCoordsOffset = AlignUp(header.normalsOffset + normals.size() * sizeof(glm::vec3));
+        header.indicesOffset = AlignUp(header.texCoordsOffset + texCoords.size() * sizeof(glm::vec2));
+        header.fileSize = AlignUp(header.indicesOffset + uint64_t(indices.size()) * header.indexSize);
+
+        std::vector<uint8_t> image(header.fileSize, 0);
+        std::memcpy(image.data(), &header, sizeof(header));
+        std::memcpy(image.data() + header.positionsOffset, positions.data(), positions.size() * sizeof(glm::vec3));
+        std::memcpy(image.data() + header.normalsOffset, normals.data(), normals.size() * sizeof(glm::vec3));
+        std::memcpy(image.data() + header.texCoordsOffset, texCoords.data(), texCoords.size() * sizeof(glm::vec2));
+
+        if (header.indexSize == 2) {
+            auto* out = reinterpret_cast<uint16_t*>(image.data() + header.indicesOffset);
+            for (size_t i = 0; i < indices.size(); ++i) {
+                out[i] = static_cast<uint16_t>(indices[i]);
+            }
+        } else {
+            std::memcpy(image.data() + header.indicesOffset, indices.data(), indices.size() * sizeof(uint32_t));
+        }
+
+        return image;
+    }
+
+    // Writes through a temporary file so a crash never leaves a torn cache behind.
+    // Failing to write (read only install, file in use) only costs the next startup.
+    void WriteImage(const std::string& cachePath, const std::vector<uint8_t>& image) {
+        const std::string tmpPath = cachePath + ".tmp";
+        {
+            std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+            if (!out) {
+                std::cerr << "Could not write mesh cache " << cachePath << std::endl;
+                std::error_code ignored;
+                std::filesystem::remove(tmpPath, ignored);
+                return;
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(tmpPath, cachePath, error);
+        if (error) {
+            std::cerr << "Could not replace mesh cache " << cachePath << ": " << error.message() << std::endl;
+            std::filesystem::remove(tmpPath, error);
+        }
+    }
+
+    // Stores the OBJ's new time in a cache that still matches it by content,
+    // so the next startup takes the size and time check again rather than
+    // hashing the OBJ. Failing only costs that hash.
+    void UpdateSourceTime(const std::string& cachePath, int64_t time) {
+        std::fstream file(cachePath, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(offsetof(MeshCacheHeader, sourceTime));
+        file.write(reinterpret_cast<const char*>(&time), sizeof(time));
+        if (!file) {
+            std::cerr << "Could not update mesh cache " << cachePath << std::endl;
+        }
+    }
+}
+
+std::string MeshData::CachePath(const std::string& objPath) {
+    return objPath + ".meshcache";
+}
+
+std::shared_ptr<const MeshData> MeshData::Load(const std::string& objPath, JobSystem* jobs) {
+    SourceInfo source;
+    if (!StatSource(objPath, source)) {
+        throw std::runtime_error("Failed to load OBJ: " + objPath);
+    }
+
+    auto mesh = std::make_shared<MeshData>();
+    const std::string cachePath = CachePath(objPath);
+
+    if (mesh->mapping.Open(cachePath) && IsValidImage(mesh->mapping.Data(), mesh->mapping.Size())) {
+        const auto& h = *reinterpret_cast<const MeshCacheHeader*>(mesh->mapping.Data());
+
+        bool upToDate = h.sourceSize == source.size && h.sourceTime == source.time;
+
+        // A touched but unchanged OBJ (checkout, copy) still matches by content.
+        // The mapping is read only (and locks the file on Windows), so it is
+        // reopened around the header update.
+        if (!upToDate && h.sourceSize == source.size && h.sourceHash == HashFile(objPath)) {
+            mesh->mapping.Close();
+            UpdateSourceTime(cachePath, source.time);
+            upToDate = mesh->mapping.Open(cachePath) && IsValidImage(mesh->mapping.Data(), mesh->mapping.Size());
+        }
+        if (upToDate) {
+            mesh->bytes = mesh->mapping.Data();
+            mesh->header = reinterpret_cast<const MeshCacheHeader*>(mesh->bytes);
+            mesh->ComputeBounds();
+            return mesh;
+        }
+    }
+    mesh->mapping.Close();
+
+    mesh->image = BuildImage(objPath, source, jobs);
+    WriteImage(cachePath, mesh->image);
+
+    mesh->bytes = mesh->image.data();
+    mesh->header = reinterpret_cast<const MeshCacheHeader*>(mesh->bytes);
+    mesh->ComputeBounds();
+
+    std::cout << "Built mesh cache: " << cachePath
+              << " (" << mesh->GetVertexCount() << " vertices, "
+              << mesh->GetIndexCount() / 3 << " triangles)\n";
+
+    return mesh;
+}
+
+void MeshData::ComputeBounds() {
+    const glm::vec3* positions = GetPositions();
+    const size_t count = GetVertexCount();
+    if (count == 0) return;
+
+    boundsMin = boundsMax = positions[0];
+    for (size_t i = 1; i < count; ++i) {
+        boundsMin = glm::min(boundsMin, positions[i]);
+        boundsMax = glm::max(boundsMax, positions[i]);
+    }
+}
@@ -0,0 +1,330 @@
+#include "core/assets/obj_parser.h"
+
+#include "core/assets/mapped_file.h"
+#include "core/job_system.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+namespace {
+
+    // Smallest chunk worth a job of its own
+    constexpr size_t kMinChunkBytes = 256 * 1024;
+
+    enum Attribute { kVertex, kNormal, kTexCoord };
+
+    // Everything parsed from one chunk of lines
+    struct ObjChunk {
+        const char* begin = nullptr;
+        const char* end = nullptr;
+
+        std::vector<float> vertices;
+        std::vector<float> normals;
+        std::vector<float> texcoords;
+
+        // Triangles (polygons are fanned), indices already zero based
+        std::vector<tinyobj::index_t> indices;
+
+        // A 'g' or 'o' line: faces from `index` on belong to a new shape `name`
+        struct ShapeStart {
+            size_t index;
+            std::string name;
+        };
+        std::vector<ShapeStart> shapeStarts;
+
+        // Negative (relative) indices were resolved against this chunk's own
+        // counts; the merge adds the counts of all earlier chunks
+        struct Relative {
+            size_t index;
+            Attribute attribute;
+        };
+        std::vector<Relative> relative;
+    };
+
+    bool IsSpace(char c) { return c == ' ' || c == '\t'; }
+
+    const char* SkipSpace(const char* p, const char* end) {
+        while (p < end && IsSpace(*p)) ++p;
+        return p;
+    }
+
+    const char* TokenEnd(const char* p, const char* end) {
+        while (p < end && !IsSpace(*p) && *p != '\r') ++p;
+        return p;
+    }
+
+    // Like tinyobj: parsed as double, missing or malformed values keep the default
+    float ParseFloat(const char*& p, const char* end, double value = 0.0) {
+        p = SkipSpace(p, end);
+        const char* tokenEnd = TokenEnd(p, end);
+
+        const char* first = (p < tokenEnd && *p == '+') ? p + 1 : p;
+        std::from_chars(first, tokenEnd, value);
+
+        p = tokenEnd;
+        return static_cast<float>(value);
+    }
+
+    // atoi semantics: leading digits only, 0 if there are none
+    int ParseInt(const char*& p, const char* end) {
+        const char* first = (p < end && *p == '+') ? p + 1 : p;
+        int value = 0;
+        std::from_chars(first, end, value);
+        return value;
+    }
+
+    // OBJ indices are one based, negative ones count back from the newest element
+    int ResolveIndex(int idx, int count, bool& relative) {
+        relative = idx < 0;
+        if (idx > 0) return idx - 1;
+        if (idx == 0) return 0;
+        return count + idx;
+    }
+
+    struct FaceVertex {
+        tinyobj::index_t index;
+        bool relative[3];
+    };
+
+    // v, v/t, v//n or v/t/n
+    FaceVertex ParseFaceVertex(const char*& p, const char* end, const ObjChunk& chunk) {
+        FaceVertex fv{{-1, -1, -1}, {false, false, false}};
+        auto skipField = [&] { while (p < end && *p != '/' && !IsSpace(*p) && *p != '\r') ++p; };
+
+        fv.index.vertex_index = ResolveIndex(ParseInt(p, end),
+            static_cast<int>(chunk.vertices.size() / 3), fv.relative[kVertex]);
+        skipField();
+        if (p >= end || *p != '/') return fv;
+        ++p;
+
+        if (p < end && *p == '/') {
+            ++p;
+            fv.index.normal_index = ResolveIndex(ParseInt(p, end),
+                static_cast<int>(chunk.normals.size() / 3), fv.relative[kNormal]);
+            skipField();
+            return fv;
+        }
+
+        fv.index.texcoord_index = ResolveIndex(ParseInt(p, end),
+            static_cast<int>(chunk.texcoords.size() / 2), fv.relative[kTexCoord]);
+        skipField();
+        if (p >= end || *p != '/') return fv;
+        ++p;
+
+        fv.index.normal_index = ResolveIndex(ParseInt(p, end),
+            static_cast<int>(chunk.normals.size() / 3), fv.relative[kNormal]);
+        skipField();
+        return fv;
+    }
+
+    void PushIndex(ObjChunk& chunk, const FaceVertex& fv) {
+        for (int a = 0; a < 3; ++a) {
+            if (fv.relative[a]) {
+                chunk.relative.push_back({chunk.indices.size(), static_cast<Attribute>(a)});
+            }
+        }
+        chunk.indices.push_back(fv.index);
+    }
+
+    std::string ParseName(const char* p, const char* end) {
+        p = SkipSpace(p, end);
+        return std::string(p, TokenEnd(p, end));
+    }
+
+    void ParseChunk(ObjChunk& chunk) {
+        std::vector<FaceVertex> face;
+
+        const char* line = chunk.begin;
+        while (line < chunk.end) {
+            const char* lineEnd = static_cast<const char*>(std::memchr(line, '\n', chunk.end - line));
+            if (!lineEnd) lineEnd = chunk.end;
+
+            const char* p = SkipSpace(line, lineEnd);
+            const char* end = lineEnd;
+            if (end > p && end[-1] == '\r') --end;
+            line = lineEnd + 1;
+
+            if (p + 1 >= end) continue;  // empty line or lone keyword
+
+            if (p[0] == 'v' && IsSpace(p[1])) {
+                p += 2;
+                chunk.vertices.push_back(ParseFloat(p, end));
+                chunk.vertices.push_back(ParseFloat(p, end));
+                chunk.vertices.push_back(ParseFloat(p, end));
+            }
+            else if (p[0] == 'v' && p[1] == 'n' && p + 2 < end && IsSpace(p[2])) {
+                p += 3;
+                chunk.normals.push_back(ParseFloat(p, end));
+                chunk.normals.push_back(ParseFloat(p, end));
+                chunk.normals.push_back(ParseFloat(p, end));
+            }
+            else if (p[0] == 'v' && p[1] == 't' && p + 2 < end && IsSpace(p[2])) {
+                p += 3;
+                chunk.texcoords.push_back(ParseFloat(p, end));
+                chunk.texcoords.push_back(ParseFloat(p, end));
+            }
+            else if (p[0] == 'f' && IsSpace(p[1])) {
+                p = SkipSpace(p + 2, end);
+
+                face.clear();
+                while (p < end) {
+                    face.push_back(ParseFaceVertex(p, end, chunk));
+                    while (p < end && (IsSpace(*p) || *p == '\r')) ++p;
+                }
+
+                // Polygon -> triangle fan, same as tinyobj
+                for (size_t k = 2; k < face.size(); ++k) {
+                    PushIndex(chunk, face[0]);
+                    PushIndex(chunk, face[k - 1]);
+                    PushIndex(chunk, face[k]);
+                }
+            }
+            else if ((p[0] == 'g' || p[0] == 'o') && IsSpace(p[1])) {
+                chunk.shapeStarts.push_back({chunk.indices.size(), ParseName(p + 2, end)});
+            }
+            // Comments, materials, smoothing groups and tags are skipped
+        }
+    }
+
+    // Splits the file into roughly equal pieces that start at a line start
+    std::vector<ObjChunk> SplitIntoChunks(const char* data, size_t size, size_t chunkCount) {
+        std::vector<ObjChunk> chunks;
+        const char* end = data + size;
+        const size_t target = size / chunkCount + 1;
+
+        const char* begin = data;
+        while (begin < end) {
+            const char* split = begin + std::min(target, static_cast<size_t>(end - begin));
+            if (split < end) {
+                const char* newline = static_cast<const char*>(std::memchr(split, '\n', end - split));
+                split = newline ? newline + 1 : end;
+            }
+
+            chunks.emplace_back();
+            chunks.back().begin = begin;
+            chunks.back().end = split;
+            begin = split;
+        }
+        return chunks;
+    }
+
+    // A run of one chunk's triangles that lands in one output shape
+    struct Segment {
+        size_t chunk;
+        size_t begin, end;     // in the chunk's indices
+        size_t shape;
+        size_t offset;         // in the shape's indices
+    };
+}
+
+bool ParseObj(
+    const std::string& path,
+    tinyobj::attrib_t& attrib,
+    std::vector<tinyobj::shape_t>& shapes,
+    std::string& err,
+    JobSystem* jobs)
+{
+    MappedFile file;
+    if (!file.Open(path)) {
+        err = "Cannot open file [" + path + "]";
+        return false;
+    }
+
+    attrib = tinyobj::attrib_t();
+    shapes.clear();
+
+    const char* data = reinterpret_cast<const char*>(file.Data());
+    const size_t threadCount = jobs ? jobs->GetThreadCount() : 1;
+    const size_t chunkCount = std::max<size_t>(1, std::min(threadCount * 4, file.Size() / kMinChunkBytes));
+
+    std::vector<ObjChunk> chunks = SplitIntoChunks(data, file.Size(), chunkCount);
+
+    auto parallelFor = [&](size_t count, const std::function<void(size_t, size_t)>& fn) {
+        if (jobs) jobs->ParallelFor(count, 1, fn);
+        else fn(0, count);
+    };
+
+    parallelFor(chunks.size(), [&](size_t first, size_t last) {
+        for (size_t c = first; c < last; ++c) ParseChunk(chunks[c]);
+    });
+
+    // Where every chunk's elements start in the merged arrays
+    std::vector<size_t> vertexBase(chunks.size() + 1, 0);
+    std::vector<size_t> normalBase(chunks.size() + 1, 0);
+    std::vector<size_t> texcoordBase(chunks.size() + 1, 0);
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        vertexBase[c + 1] = vertexBase[c] + chunks[c].vertices.size();
+        normalBase[c + 1] = normalBase[c] + chunks[c].normals.size();
+        texcoordBase[c + 1] = texcoordBase[c] + chunks[c].texcoords.size();
+    }
+
+    // Cut the triangles into shapes at 'g' / 'o' lines. Like tinyobj, a shape
+    // only exists if it has faces, and takes the most recent name.
+    std::vector<Segment> segments;
+    std::vector<size_t> shapeSizes;
+    std::string name;
+    bool shapeOpen = false;
+
+    auto addSegment = [&](size_t c, size_t begin, size_t end) {
+        if (begin == end) return;
+        if (!shapeOpen) {
+            shapes.emplace_back();
+            shapes.back().name = name;
+            shapeSizes.push_back(0);
+            shapeOpen = true;
+        }
+        segments.push_back({c, begin, end, shapes.size() - 1, shapeSizes.back()});
+        shapeSizes.back() += end - begin;
+    };
+
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        size_t begin = 0;
+        for (const auto& start : chunks[c].shapeStarts) {
+            addSegment(c, begin, start.index);
+            begin = start.index;
+            name = start.name;
+            shapeOpen = false;
+        }
+        addSegment(c, begin, chunks[c].indices.size());
+    }
+
+    for (size_t s = 0; s < shapes.size(); ++s) {
+        shapes[s].mesh.indices.resize(shapeSizes[s]);
+        shapes[s].mesh.num_face_vertices.assign(shapeSizes[s] / 3, 3);
+        shapes[s].mesh.material_ids.assign(shapeSizes[s] / 3, -1);
+    }
+    attrib.vertices.resize(vertexBase.back());
+    attrib.normals.resize(normalBase.back());
+    attrib.texcoords.resize(texcoordBase.back());
+
+    // Resolve relative indices and copy everything into place
+    parallelFor(chunks.size(), [&](size_t first, size_t last) {
+        for (size_t c = first; c < last; ++c) {
+            ObjChunk& chunk = chunks[c];
+            for (const auto& r : chunk.relative) {
+                tinyobj::index_t& idx = chunk.indices[r.index];
+                switch (r.attribute) {
+                    case kVertex:   idx.vertex_index += static_cast<int>(vertexBase[c] / 3); break;
+                    case kNormal:   idx.normal_index += static_cast<int>(normalBase[c] / 3); break;
+                    case kTexCoord: idx.texcoord_index += static_cast<int>(texcoordBase[c] / 2); break;
+                }
+            }
+
+            std::copy(chunk.vertices.begin(), chunk.vertices.end(), attrib.vertices.begin() + vertexBase[c]);
+            std::copy(chunk.normals.begin(), chunk.normals.end(), attrib.normals.begin() + normalBase[c]);
+            std::copy(chunk.texcoords.begin(), chunk.texcoords.end(), attrib.texcoords.begin() + texcoordBase[c]);
+        }
+    });
+
+    parallelFor(segments.size(), [&](size_t first, size_t last) {
+        for (size_t s = first; s < last; ++s) {
+            const Segment& seg = segments[s];
+            const auto& indices = chunks[seg.chunk].indices;
+            std::copy(indices.begin() + seg.begin, indices.begin() + seg.end,
+                      shapes[seg.shape].mesh.indices.begin() + seg.offset);
+        }
+    });
+
+    return true;
+}
@@ -0,0 +1,40 @@
+#include "core/assets/welded_mesh.h"
+
+#include "core/assets/mesh_data.h"
+
+#include <unordered_map>
+
+namespace {
+    // Map to keep only unique vertices by position
+    struct Vec3Hash {
+        size_t operator()(const glm::vec3& v) const {
+            return std::hash<float>()(v.x) ^ std::hash<float>()(v.y) ^ std::hash<float>()(v.z);
+        }
+    };
+}
+
+WeldedMesh WeldedMesh::Build(const MeshData& mesh) {
+    WeldedMesh welded;
+    const glm::vec3* renderPositions = mesh.GetPositions();
+
+    std::unordered_map<glm::vec3, uint32_t, Vec3Hash> posMap;
+    welded.indices.resize(mesh.GetIndexCount());
+    welded.weldedOfRenderVertex.assign(mesh.GetVertexCount(), 0);
+
+    // Walk the triangles so welded vertices are numbered in order of first use
+    for (size_t i = 0; i < welded.indices.size(); ++i) {
+        const uint32_t renderVertex = mesh.GetIndex(i);
+        const glm::vec3& pos = renderPositions[renderVertex];
+
+        auto it = posMap.find(pos);
+        if (it == posMap.end()) {
+            it = posMap.emplace(pos, static_cast<uint32_t>(welded.positions.size())).first;
+            welded.positions.push_back(pos);
+        }
+
+        welded.indices[i] = it->second;
+        welded.weldedOfRenderVertex[renderVertex] = it->second;
+    }
+
+    return welded;
+}
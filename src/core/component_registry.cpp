@@ -0,0 +1,92 @@
+#include "core/component_registry.h"
+
+#include "core/game_object.h"
+
+ComponentRegistry::~ComponentRegistry() {
+    for (GameObject* object : objects) {
+        if (object) object->registry = nullptr;
+    }
+}
+
+void ComponentRegistry::Add(GameObject& object) {
+    if (object.registry == this) return;
+    if (object.registry) object.registry->Remove(object);
+
+    const Entity entity = object.GetEntity();
+    if (entity >= objects.size()) {
+        objects.resize(entity + 1, nullptr);
+    }
+    objects[entity] = &object;
+    if (entity >= masks.size()) {
+        masks.resize(entity + 1, 0);
+    }
+    masks[entity] = 0;
+    object.registry = this;
+}
+
+void ComponentRegistry::Remove(GameObject& object) {
+    if (object.registry != this) return;
+
+    const Entity entity = object.GetEntity();
+    for (size_t type = 0; type < NUM_ENUM; ++type) {
+        RemoveComponent(entity, static_cast<COMPONENT_TYPE>(type));
+    }
+    objects[entity] = nullptr;
+    object.registry = nullptr;
+}
+
+const std::vector<Entity>& ComponentRegistry::GetEntities(COMPONENT_TYPE type) const {
+    switch (type) {
+        case TRANSFORM: return Pool<Transform>().Entities();
+        case MATERIAL: return Pool<Material>().Entities();
+        case MODEL: return Pool<Model>().Entities();
+        case LIGHT: return Pool<PointLight>().Entities();
+        case SOFTBODY: return Pool<SoftBody>().Entities();
+        default: ;
+    }
+
+    static const std::vector<Entity> none;
+    return none;
+}
+
+void ComponentRegistry::SetComponent(Entity entity, Component&& component) {
+    // Components of each type are only ever created as that class, so the
+    // downcasts are static
+    switch (component.type) {
+        case TRANSFORM: SetComponent(entity, static_cast<Transform&&>(component)); break;
+        case MATERIAL: SetComponent(entity, static_cast<Material&&>(component)); break;
+        case MODEL: SetComponent(entity, static_cast<Model&&>(component)); break;
+        case LIGHT: SetComponent(entity, static_cast<PointLight&&>(component)); break;
+        case SOFTBODY: SetComponent(entity, static_cast<SoftBody&&>(component)); break;
+        default: ;
+    }
+}
+
+Component* ComponentRegistry::GetComponent(Entity entity, COMPONENT_TYPE type) {
+    switch (type) {
+        case TRANSFORM: return Pool<Transform>().Get(entity);
+        case MATERIAL: return Pool<Material>().Get(entity);
+        case MODEL: return Pool<Model>().Get(entity);
+        case LIGHT: return Pool<PointLight>().Get(entity);
+        case SOFTBODY: return Pool<SoftBody>().Get(entity);
+        default: return nullptr;
+    }
+}
+
+void ComponentRegistry::RemoveComponent(Entity entity, COMPONENT_TYPE type) {
+    if (entity < masks.size()) masks[entity] &= ~MaskOf(type);
+
+    switch (type) {
+        case TRANSFORM: Pool<Transform>().Erase(entity); break;
+        case MATERIAL: Pool<Material>().Erase(entity); break;
+        case MODEL: Pool<Model>().Erase(entity); break;
+        case LIGHT: Pool<PointLight>().Erase(entity); break;
+        case SOFTBODY:
+            if (Pool<SoftBody>().Contains(entity)) {
+                Pool<SoftBody>().Erase(entity);
+                removedSoftBodies.push_back(entity);
+            }
+            break;
+        default: ;
+    }
+}
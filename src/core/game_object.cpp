@@ -1,3 +0,0 @@
-#include "core/game_object.h"
-
-int GameObject::lastId = 0;
\ No newline at end of file
@@ -0,0 +1,280 @@
+#include "core/job_system.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace {
+    // Which JobSystem (if any) the current thread works for, and its queue
+    thread_local JobSystem* tlsOwner = nullptr;
+    thread_local size_t tlsQueue = 0;
+}
+
+// ---------------------------------------------------------------- TaskGraph
+
+TaskGraph::NodeId TaskGraph::Add(std::function<void()> fn) {
+    auto node = std::make_unique<Node>();
+    node->fn = std::move(fn);
+    nodes.push_back(std::move(node));
+    return nodes.size() - 1;
+}
+
+void TaskGraph::Precede(NodeId before, NodeId after) {
+    nodes[before]->successors.push_back(after);
+    nodes[after]->predecessorCount++;
+}
+
+void TaskGraph::Launch(JobSystem& jobs, NodeId id, JobCounter& done) {
+    // A successor is submitted before its last predecessor's job finishes,
+    // so `done` cannot reach zero while part of the graph is still to come
+    jobs.Submit([this, &jobs, id, &done] {
+        Node& node = *nodes[id];
+        node.fn();
+
+        for (NodeId next : node.successors) {
+            if (nodes[next]->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                Launch(jobs, next, done);
+            }
+        }
+    }, &done);
+}
+
+void TaskGraph::Run(JobSystem& jobs) {
+    for (auto& node : nodes) {
+        node->pending.store(node->predecessorCount, std::memory_order_relaxed);
+    }
+
+    JobCounter done;
+    for (NodeId id = 0; id < nodes.size(); ++id) {
+        if (nodes[id]->predecessorCount == 0) {
+            Launch(jobs, id, done);
+        }
+    }
+    jobs.Wait(done);
+}
+
+// ---------------------------------------------------------------- JobSystem
+
+JobSystem::JobSystem(size_t threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Worker queues plus the shared queue for outside threads
+    for (size_t i = 0; i < threadCount; ++i) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+
+    // The caller counts as one of the threads
+    for (size_t i = 0; i + 1 < threadCount; ++i) {
+        workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+size_t JobSystem::CurrentQueue() const {
+    return tlsOwner == this ? tlsQueue : queues.size() - 1;
+}
+
+void JobSystem::Submit(Job job, JobCounter* counter) {
+    if (counter) {
+        counter->value.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (IsSingleThreaded()) {
+        job();
+        if (counter) {
+            counter->value.fetch_sub(1, std::memory_order_release);
+        }
+        return;
+    }
+
+    if (counter) {
+        job = [inner = std::move(job), counter] {
+            inner();
+            counter->value.fetch_sub(1, std::memory_order_release);
+        };
+    }
+
+    Queue& queue = *queues[CurrentQueue()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+    }
+    queuedJobs.fetch_add(1, std::memory_order_release);
+
+    // Taking the lock orders us against a worker about to fall asleep
+    { std::lock_guard<std::mutex> lock(sleepMutex); }
+    wakeUp.notify_one();
+}
+
+void JobSystem::SubmitBackground(Job job) {
+    if (IsSingleThreaded()) {
+        job();
+        return;
+    }
+
+    bool queued = false;
+    {
+        std::lock_guard<std::mutex> lock(backgroundQueue.mutex);
+        if (!backgroundClosed) {
+            backgroundQueue.jobs.push_back(std::move(job));
+            queuedBackgroundJobs.fetch_add(1, std::memory_order_release);
+            queued = true;
+        }
+    }
+    if (!queued) {
+        job();
+        return;
+    }
+
+    { std::lock_guard<std::mutex> lock(sleepMutex); }
+    wakeUp.notify_one();
+}
+
+std::vector<JobSystem::Job> JobSystem::TakeBackgroundJobs() {
+    std::lock_guard<std::mutex> lock(backgroundQueue.mutex);
+    backgroundClosed = true;
+
+    std::vector<Job> jobs(std::make_move_iterator(backgroundQueue.jobs.begin()),
+                          std::make_move_iterator(backgroundQueue.jobs.end()));
+    backgroundQueue.jobs.clear();
+    queuedBackgroundJobs.fetch_sub(jobs.size(), std::memory_order_relaxed);
+    return jobs;
+}
+
+JobSystem* JobSystem::Current() {
+    return tlsOwner;
+}
+
+bool JobSystem::PopBack(size_t queue, Job& job) {
+    Queue& q = *queues[queue];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (q.jobs.empty()) {
+        return false;
+    }
+    job = std::move(q.jobs.back());
+    q.jobs.pop_back();
+    return true;
+}
+
+bool JobSystem::StealFront(size_t queue, Job& job) {
+    Queue& q = *queues[queue];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (q.jobs.empty()) {
+        return false;
+    }
+    job = std::move(q.jobs.front());
+    q.jobs.pop_front();
+    return true;
+}
+
+bool JobSystem::TryRunJob(size_t ownQueue) {
+    if (queuedJobs.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+
+    Job job;
+    bool found = PopBack(ownQueue, job);
+    for (size_t i = 1; !found && i < queues.size(); ++i) {
+        found = StealFront((ownQueue + i) % queues.size(), job);
+    }
+
+    if (!found) {
+        return false;
+    }
+
+    queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+    job();
+    return true;
+}
+
+bool JobSystem::TryRunBackgroundJob() {
+    if (queuedBackgroundJobs.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+
+    Job job;
+    {
+        std::lock_guard<std::mutex> lock(backgroundQueue.mutex);
+        if (backgroundQueue.jobs.empty()) {
+            return false;
+        }
+        job = std::move(backgroundQueue.jobs.front());
+        backgroundQueue.jobs.pop_front();
+    }
+
+    queuedBackgroundJobs.fetch_sub(1, std::memory_order_relaxed);
+    job();
+    return true;
+}
+
+bool JobSystem::HasQueuedJobs() const {
+    return queuedJobs.load(std::memory_order_acquire) > 0 ||
+           queuedBackgroundJobs.load(std::memory_order_acquire) > 0;
+}
+
+void JobSystem::WorkerLoop(size_t index) {
+    tlsOwner = this;
+    tlsQueue = index;
+
+    for (;;) {
+        if (TryRunJob(index) || TryRunBackgroundJob()) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        if (stopping.load() && !HasQueuedJobs()) {
+            return;
+        }
+        wakeUp.wait(lock, [this] {
+            return stopping.load() || HasQueuedJobs();
+        });
+    }
+}
+
+void JobSystem::Wait(JobCounter& counter) {
+    const size_t own = CurrentQueue();
+    while (counter.value.load(std::memory_order_acquire) > 0) {
+        if (!TryRunJob(own)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::ParallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& fn) {
+    if (count == 0) {
+        return;
+    }
+
+    grainSize = std::max<size_t>(1, grainSize);
+
+    // Not worth queueing anything
+    if (IsSingleThreaded() || count <= grainSize) {
+        fn(0, count);
+        return;
+    }
+
+    const size_t chunkCount = (count + grainSize - 1) / grainSize;
+
+    JobCounter counter;
+    for (size_t chunk = 0; chunk + 1 < chunkCount; ++chunk) {
+        Submit([&fn, chunk, grainSize] {
+            fn(chunk * grainSize, (chunk + 1) * grainSize);
+        }, &counter);
+    }
+
+    // The last (possibly short) chunk runs here, then help with the rest
+    fn((chunkCount - 1) * grainSize, count);
+    Wait(counter);
+}
@@ -61,15 +61,5 @@ void MainEngine::MouseCallback(GLFWwindow* window, int button, int action, int m
 }
 
 void MainEngine::runSimulation() {
-    const auto models = GetCurrScene()->GetModels();
-    for (const auto &curr: models) {
-        SoftBody *body = dynamic_cast<SoftBody *>(curr->GetComponent(SOFTBODY));
-        if (body) {
-            float dt = timeDelta.count();
-            std::cout << "Running simulation loop: " << dt << "s " << std::endl;
-            body->Integrate(dt, gravity);
-            body->SolveConstraints(dt);
-            body->SolveFloorCollision(0.0f); // floor at y = 0
-        }
-    }
-}
\ No newline at end of file
+    physics.Update(*GetCurrScene(), timeDelta.count(), *jobSystem);
+}
@@ -0,0 +1,90 @@
+#include "core/physics/mesh_reorder.h"
+
+#include <algorithm>
+
+std::vector<uint32_t> ReverseCuthillMcKee(size_t vertexCount, const std::vector<uint32_t>& triangleIndices) {
+    // Neighbour lists in CSR form: the neighbours of v are
+    // indices[offsets[v] .. offsets[v + 1]), duplicates removed
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    for (size_t t = 0; t + 2 < triangleIndices.size(); t += 3) {
+        for (int k = 0; k < 3; ++k) {
+            offsets[triangleIndices[t + k] + 1] += 2;
+        }
+    }
+    for (size_t v = 0; v < vertexCount; ++v) offsets[v + 1] += offsets[v];
+
+    std::vector<uint32_t> indices(offsets[vertexCount]);
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (size_t t = 0; t + 2 < triangleIndices.size(); t += 3) {
+        for (int k = 0; k < 3; ++k) {
+            const uint32_t a = triangleIndices[t + k];
+            const uint32_t b = triangleIndices[t + (k + 1) % 3];
+            indices[fill[a]++] = b;
+            indices[fill[b]++] = a;
+        }
+    }
+
+    // Dedupe each list and compact them towards the front
+    std::vector<uint32_t> degree(vertexCount);
+    uint32_t end = 0;
+    for (size_t v = 0; v < vertexCount; ++v) {
+        const auto first = indices.begin() + offsets[v];
+        const auto last = indices.begin() + offsets[v + 1];
+        std::sort(first, last);
+        const auto unique = std::unique(first, last);
+
+        const auto count = static_cast<uint32_t>(unique - first);
+        if (end != offsets[v]) std::copy(first, unique, indices.begin() + end);
+        offsets[v] = end;
+        degree[v] = count;
+        end += count;
+    }
+    offsets[vertexCount] = end;
+    indices.resize(end);
+
+    // Visit neighbours lowest degree first
+    for (size_t v = 0; v < vertexCount; ++v) {
+        std::stable_sort(indices.begin() + offsets[v], indices.begin() + offsets[v + 1],
+                         [&](uint32_t a, uint32_t b) { return degree[a] < degree[b]; });
+    }
+
+    // Seeds: start every connected component from a vertex of minimum degree
+    std::vector<uint32_t> seeds(vertexCount);
+    for (uint32_t v = 0; v < vertexCount; ++v) seeds[v] = v;
+    std::stable_sort(seeds.begin(), seeds.end(), [&](uint32_t a, uint32_t b) { return degree[a] < degree[b]; });
+
+    std::vector<uint32_t> order;
+    order.reserve(vertexCount);
+    std::vector<bool> visited(vertexCount, false);
+
+    for (uint32_t seed : seeds) {
+        if (visited[seed]) continue;
+
+        // Breadth first search, the order vector doubles as the queue
+        size_t head = order.size();
+        order.push_back(seed);
+        visited[seed] = true;
+
+        while (head < order.size()) {
+            const uint32_t v = order[head++];
+            for (uint32_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+                const uint32_t n = indices[i];
+                if (!visited[n]) {
+                    visited[n] = true;
+                    order.push_back(n);
+                }
+            }
+        }
+    }
+
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+std::vector<uint32_t> InvertPermutation(const std::vector<uint32_t>& order) {
+    std::vector<uint32_t> inverse(order.size());
+    for (uint32_t i = 0; i < order.size(); ++i) {
+        inverse[order[i]] = i;
+    }
+    return inverse;
+}
@@ -0,0 +1,246 @@
+#include "core/physics/simd_kernels.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PHYSICS_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+// MSVC allows AVX intrinsics in any function, no per-function target needed
+#define PHYSICS_TARGET_AVX2
+#else
+#define PHYSICS_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#endif
+#endif
+
+namespace {
+
+    // ---------------------------------------------------------------- scalar
+
+    void IntegrateScalar(ParticleStore& p, float ax, float ay, float az) {
+        const size_t n = p.PaddedSize();
+        for (size_t i = 0; i < n; ++i) {
+            const float m = p.invMass[i] != 0.0f ? 1.0f : 0.0f;
+
+            const float cx = p.x[i], cy = p.y[i], cz = p.z[i];
+            p.x[i] = cx + m * ((cx - p.px[i]) + ax);
+            p.y[i] = cy + m * ((cy - p.py[i]) + ay);
+            p.z[i] = cz + m * ((cz - p.pz[i]) + az);
+
+            p.px[i] += m * (cx - p.px[i]);
+            p.py[i] += m * (cy - p.py[i]);
+            p.pz[i] += m * (cz - p.pz[i]);
+        }
+    }
+
+    void CollideScalar(ParticleStore& p, float nx, float ny, float nz, float offset, float bounce) {
+        const size_t n = p.PaddedSize();
+        for (size_t i = 0; i < n; ++i) {
+            float pen = offset - (nx * p.x[i] + ny * p.y[i] + nz * p.z[i]);
+            pen = (pen > 0.0f && p.invMass[i] != 0.0f) ? pen : 0.0f;
+
+            p.x[i] += nx * pen;
+            p.y[i] += ny * pen;
+            p.z[i] += nz * pen;
+
+            const float dn = nx * (p.px[i] - p.x[i]) + ny * (p.py[i] - p.y[i]) + nz * (p.pz[i] - p.z[i]);
+            const float s = pen > 0.0f ? dn * bounce : 0.0f;
+            p.px[i] -= nx * s;
+            p.py[i] -= ny * s;
+            p.pz[i] -= nz * s;
+        }
+    }
+
+#ifdef PHYSICS_SIMD_X86
+
+    // ------------------------------------------------------------------ SSE2
+
+    inline __m128 Select128(__m128 a, __m128 b, __m128 mask) {
+        return _mm_or_ps(_mm_and_ps(mask, b), _mm_andnot_ps(mask, a));
+    }
+
+    void IntegrateSSE2(ParticleStore& p, float ax, float ay, float az) {
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 accel[3] = {_mm_set1_ps(ax), _mm_set1_ps(ay), _mm_set1_ps(az)};
+        float* cur[3] = {p.x.data(), p.y.data(), p.z.data()};
+        float* prev[3] = {p.px.data(), p.py.data(), p.pz.data()};
+
+        const size_t n = p.PaddedSize();
+        for (size_t i = 0; i < n; i += 4) {
+            const __m128 mask = _mm_cmpneq_ps(_mm_load_ps(p.invMass.data() + i), zero);
+            for (int k = 0; k < 3; ++k) {
+                const __m128 c = _mm_load_ps(cur[k] + i);
+                const __m128 o = _mm_load_ps(prev[k] + i);
+                const __m128 next = _mm_add_ps(_mm_add_ps(c, _mm_sub_ps(c, o)), accel[k]);
+                _mm_store_ps(cur[k] + i, Select128(c, next, mask));
+                _mm_store_ps(prev[k] + i, Select128(o, c, mask));
+            }
+        }
+    }
+
+    void CollideSSE2(ParticleStore& p, float nx, float ny, float nz, float offset, float bounce) {
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 vnx = _mm_set1_ps(nx), vny = _mm_set1_ps(ny), vnz = _mm_set1_ps(nz);
+        const __m128 voff = _mm_set1_ps(offset), vb = _mm_set1_ps(bounce);
+
+        const size_t n = p.PaddedSize();
+        for (size_t i = 0; i < n; i += 4) {
+            __m128 x = _mm_load_ps(p.x.data() + i);
+            __m128 y = _mm_load_ps(p.y.data() + i);
+            __m128 z = _mm_load_ps(p.z.data() + i);
+
+            const __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vnx, x), _mm_mul_ps(vny, y)), _mm_mul_ps(vnz, z));
+            __m128 pen = _mm_sub_ps(voff, d);
+            const __m128 mask = _mm_and_ps(_mm_cmpgt_ps(pen, zero),
+                                           _mm_cmpneq_ps(_mm_load_ps(p.invMass.data() + i), zero));
+            pen = _mm_and_ps(mask, pen);
+
+            x = _mm_add_ps(x, _mm_mul_ps(vnx, pen));
+            y = _mm_add_ps(y, _mm_mul_ps(vny, pen));
+            z = _mm_add_ps(z, _mm_mul_ps(vnz, pen));
+            _mm_store_ps(p.x.data() + i, x);
+            _mm_store_ps(p.y.data() + i, y);
+            _mm_store_ps(p.z.data() + i, z);
+
+            __m128 px = _mm_load_ps(p.px.data() + i);
+            __m128 py = _mm_load_ps(p.py.data() + i);
+            __m128 pz = _mm_load_ps(p.pz.data() + i);
+            const __m128 dn = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vnx, _mm_sub_ps(px, x)),
+                                                    _mm_mul_ps(vny, _mm_sub_ps(py, y))),
+                                         _mm_mul_ps(vnz, _mm_sub_ps(pz, z)));
+            const __m128 s = _mm_and_ps(mask, _mm_mul_ps(dn, vb));
+            _mm_store_ps(p.px.data() + i, _mm_sub_ps(px, _mm_mul_ps(vnx, s)));
+            _mm_store_ps(p.py.data() + i, _mm_sub_ps(py, _mm_mul_ps(vny, s)));
+            _mm_store_ps(p.pz.data() + i, _mm_sub_ps(pz, _mm_mul_ps(vnz, s)));
+        }
+    }
+
+    // ------------------------------------------------------------------ AVX2
+
+    PHYSICS_TARGET_AVX2
+    void IntegrateAVX2(ParticleStore& p, float ax, float ay, float az) {
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 accel[3] = {_mm256_set1_ps(ax), _mm256_set1_ps(ay), _mm256_set1_ps(az)};
+        float* cur[3] = {p.x.data(), p.y.data(), p.z.data()};
+        float* prev[3] = {p.px.data(), p.py.data(), p.pz.data()};
+
+        const size_t n = p.PaddedSize();
+        for (size_t i = 0; i < n; i += 8) {
+            const __m256 mask = _mm256_cmp_ps(_mm256_load_ps(p.invMass.data() + i), zero, _CMP_NEQ_OQ);
+            for (int k = 0; k < 3; ++k) {
+                const __m256 c = _mm256_load_ps(cur[k] + i);
+                const __m256 o = _mm256_load_ps(prev[k] + i);
+                const __m256 next = _mm256_add_ps(_mm256_add_ps(c, _mm256_sub_ps(c, o)), accel[k]);
+                _mm256_store_ps(cur[k] + i, _mm256_blendv_ps(c, next, mask));
+                _mm256_store_ps(prev[k] + i, _mm256_blendv_ps(o, c, mask));
+            }
+        }
+    }
+
+    PHYSICS_TARGET_AVX2
+    void CollideAVX2(ParticleStore& p, float nx, float ny, float nz, float offset, float bounce) {
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 vnx = _mm256_set1_ps(nx), vny = _mm256_set1_ps(ny), vnz = _mm256_set1_ps(nz);
+        const __m256 voff = _mm256_set1_ps(offset), vb = _mm256_set1_ps(bounce);
+
+        const size_t n = p.PaddedSize();
+        for (size_t i = 0; i < n; i += 8) {
+            __m256 x = _mm256_load_ps(p.x.data() + i);
+            __m256 y = _mm256_load_ps(p.y.data() + i);
+            __m256 z = _mm256_load_ps(p.z.data() + i);
+
+            const __m256 d = _mm256_fmadd_ps(vnz, z, _mm256_fmadd_ps(vny, y, _mm256_mul_ps(vnx, x)));
+            __m256 pen = _mm256_sub_ps(voff, d);
+            const __m256 mask = _mm256_and_ps(_mm256_cmp_ps(pen, zero, _CMP_GT_OQ),
+                                              _mm256_cmp_ps(_mm256_load_ps(p.invMass.data() + i), zero, _CMP_NEQ_OQ));
+            pen = _mm256_and_ps(mask, pen);
+
+            x = _mm256_fmadd_ps(vnx, pen, x);
+            y = _mm256_fmadd_ps(vny, pen, y);
+            z = _mm256_fmadd_ps(vnz, pen, z);
+            _mm256_store_ps(p.x.data() + i, x);
+            _mm256_store_ps(p.y.data() + i, y);
+            _mm256_store_ps(p.z.data() + i, z);
+
+            const __m256 px = _mm256_load_ps(p.px.data() + i);
+            const __m256 py = _mm256_load_ps(p.py.data() + i);
+            const __m256 pz = _mm256_load_ps(p.pz.data() + i);
+            const __m256 dn = _mm256_fmadd_ps(vnz, _mm256_sub_ps(pz, z),
+                              _mm256_fmadd_ps(vny, _mm256_sub_ps(py, y),
+                                              _mm256_mul_ps(vnx, _mm256_sub_ps(px, x))));
+            const __m256 s = _mm256_and_ps(mask, _mm256_mul_ps(dn, vb));
+            _mm256_store_ps(p.px.data() + i, _mm256_fnmadd_ps(vnx, s, px));
+            _mm256_store_ps(p.py.data() + i, _mm256_fnmadd_ps(vny, s, py));
+            _mm256_store_ps(p.pz.data() + i, _mm256_fnmadd_ps(vnz, s, pz));
+        }
+    }
+
+#endif // PHYSICS_SIMD_X86
+
+    using simd::InstructionSet;
+
+    InstructionSet DetectInstructionSet() {
+#ifdef PHYSICS_SIMD_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 1);
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        const bool avx = (info[2] & (1 << 28)) != 0;
+        const bool fma = (info[2] & (1 << 12)) != 0;
+        __cpuidex(info, 7, 0);
+        const bool avx2 = (info[1] & (1 << 5)) != 0;
+        if (osxsave && avx && fma && avx2 && (_xgetbv(0) & 0x6) == 0x6) {
+            return InstructionSet::AVX2;
+        }
+        return InstructionSet::SSE2;
+#else
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return InstructionSet::AVX2;
+        }
+        if (__builtin_cpu_supports("sse2")) {
+            return InstructionSet::SSE2;
+        }
+#endif
+#endif
+        return InstructionSet::Scalar;
+    }
+
+}
+
+namespace simd {
+
+    InstructionSet ActiveSet() {
+        static const InstructionSet set = DetectInstructionSet();
+        return set;
+    }
+
+    const char* ActiveInstructionSet() {
+        switch (ActiveSet()) {
+            case InstructionSet::AVX2: return "avx2";
+            case InstructionSet::SSE2: return "sse2";
+            default: return "scalar";
+        }
+    }
+
+    void IntegrateVerlet(ParticleStore& particles, const glm::vec3& gravity, float dt) {
+        const glm::vec3 a = gravity * dt * dt;
+        switch (ActiveSet()) {
+#ifdef PHYSICS_SIMD_X86
+            case InstructionSet::AVX2: IntegrateAVX2(particles, a.x, a.y, a.z); return;
+            case InstructionSet::SSE2: IntegrateSSE2(particles, a.x, a.y, a.z); return;
+#endif
+            default: IntegrateScalar(particles, a.x, a.y, a.z);
+        }
+    }
+
+    void CollideHalfSpace(ParticleStore& particles, const glm::vec3& normal, float offset, float bounce) {
+        switch (ActiveSet()) {
+#ifdef PHYSICS_SIMD_X86
+            case InstructionSet::AVX2: CollideAVX2(particles, normal.x, normal.y, normal.z, offset, bounce); return;
+            case InstructionSet::SSE2: CollideSSE2(particles, normal.x, normal.y, normal.z, offset, bounce); return;
+#endif
+            default: CollideScalar(particles, normal.x, normal.y, normal.z, offset, bounce);
+        }
+    }
+
+}
@@ -0,0 +1,167 @@
+#include "core/physics/softbody_topology.h"
+
+#include "core/physics/mesh_reorder.h"
+#include "core/assets/asset_registry.h"
+
+#include <algorithm>
+#include <iostream>
+#include <unordered_set>
+
+namespace {
+
+    struct Edge {
+        uint32_t a, b;
+        bool operator==(const Edge& o) const {
+            return (a == o.a && b == o.b) || (a == o.b && b == o.a);
+        }
+    };
+
+    struct EdgeHash {
+        size_t operator()(const Edge& e) const {
+            return std::hash<uint32_t>()(e.a) ^
+                   std::hash<uint32_t>()(e.b);
+        }
+    };
+
+    // Constraints of one color never share a particle, so each color can be
+    // solved in parallel. Reorders `constraints` so every color is contiguous.
+    void ColorConstraints(SoftBodyTopology& topology) {
+        auto& constraints = topology.constraints;
+        std::vector<std::vector<uint32_t>> particleColors(topology.GetParticleCount());
+        std::vector<uint32_t> constraintColor(constraints.size());
+        uint32_t colorCount = 0;
+
+        // Greedy: smallest color not already used at either endpoint
+        for (size_t c = 0; c < constraints.size(); ++c) {
+            const auto& used0 = particleColors[constraints[c].i0];
+            const auto& used1 = particleColors[constraints[c].i1];
+
+            uint32_t color = 0;
+            while (std::find(used0.begin(), used0.end(), color) != used0.end() ||
+                   std::find(used1.begin(), used1.end(), color) != used1.end()) {
+                ++color;
+            }
+
+            constraintColor[c] = color;
+            particleColors[constraints[c].i0].push_back(color);
+            particleColors[constraints[c].i1].push_back(color);
+            colorCount = std::max(colorCount, color + 1);
+        }
+
+        // Counting sort by color, keeping the original order inside a color
+        auto& colorOffsets = topology.colorOffsets;
+        colorOffsets.assign(colorCount + 1, 0);
+        for (uint32_t color : constraintColor) {
+            ++colorOffsets[color + 1];
+        }
+        for (uint32_t i = 0; i < colorCount; ++i) {
+            colorOffsets[i + 1] += colorOffsets[i];
+        }
+
+        std::vector<uint32_t> cursor(colorOffsets.begin(), colorOffsets.end() - 1);
+        std::vector<DistanceConstraint> sorted(constraints.size());
+        for (size_t c = 0; c < constraints.size(); ++c) {
+            sorted[cursor[constraintColor[c]]++] = constraints[c];
+        }
+        constraints = std::move(sorted);
+    }
+
+    void BuildParticleAdjacency(SoftBodyTopology& topology) {
+        const auto& constraints = topology.constraints;
+        auto& offsets = topology.adjacencyOffsets;
+
+        offsets.assign(topology.GetParticleCount() + 1, 0);
+        for (const auto& c : constraints) {
+            ++offsets[c.i0 + 1];
+            ++offsets[c.i1 + 1];
+        }
+        for (size_t i = 0; i < topology.GetParticleCount(); ++i) {
+            offsets[i + 1] += offsets[i];
+        }
+
+        topology.adjacency.resize(offsets.back());
+        std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+        for (uint32_t c = 0; c < constraints.size(); ++c) {
+            topology.adjacency[cursor[constraints[c].i0]++] = c << 1;
+            topology.adjacency[cursor[constraints[c].i1]++] = (c << 1) | 1u;
+        }
+    }
+
+}
+
+std::shared_ptr<SoftBodyTopology> SoftBodyTopology::Build(const std::string& modelPath) {
+    const std::shared_ptr<const MeshData> mesh = MeshData::Load(modelPath);
+    return Build(modelPath, WeldedMesh::Build(*mesh));
+}
+
+std::shared_ptr<SoftBodyTopology> SoftBodyTopology::Build(const std::string& modelPath, const WeldedMesh& mesh) {
+    std::cout << "Loading " << modelPath << std::endl;
+
+    auto topology = std::make_shared<SoftBodyTopology>();
+    topology->modelPath = modelPath;
+    auto& restPositions = topology->restPositions;
+
+    std::vector<uint32_t> indices = mesh.indices;
+
+    // Renumber particles so mesh neighbours are neighbours in memory.
+    // restPositions and constraints both use the new numbering.
+    const std::vector<uint32_t> order = ReverseCuthillMcKee(mesh.GetVertexCount(), indices);
+    const std::vector<uint32_t> particleOfWelded = InvertPermutation(order);
+
+    restPositions.resize(order.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        restPositions[i] = mesh.positions[order[i]];
+    }
+    for (auto& idx : indices) {
+        idx = particleOfWelded[idx];
+    }
+
+    // Render vertex -> welded vertex -> particle, so a body can write its
+    // positions straight into the render vertex layout
+    topology->particleOfVertex.resize(mesh.weldedOfRenderVertex.size());
+    for (size_t v = 0; v < mesh.weldedOfRenderVertex.size(); ++v) {
+        topology->particleOfVertex[v] = particleOfWelded[mesh.weldedOfRenderVertex[v]];
+    }
+
+    // Build unique edges from triangle indices
+    std::unordered_set<Edge, EdgeHash> edges;
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        uint32_t i0 = indices[i + 0];
+        uint32_t i1 = indices[i + 1];
+        uint32_t i2 = indices[i + 2];
+
+        edges.insert({i0, i1});
+        edges.insert({i1, i2});
+        edges.insert({i2, i0});
+    }
+
+    // Create distance constraints, lower particle index first
+    auto& constraints = topology->constraints;
+    for (const auto& e : edges) {
+        const uint32_t a = std::min(e.a, e.b);
+        const uint32_t b = std::max(e.a, e.b);
+        float restLen = glm::length(restPositions[a] - restPositions[b]);
+        constraints.push_back({a, b, restLen});
+    }
+
+    // Hash set order is random; sort so the solver sweeps memory forwards
+    std::sort(constraints.begin(), constraints.end(),
+              [](const DistanceConstraint& l, const DistanceConstraint& r) {
+                  return l.i0 != r.i0 ? l.i0 < r.i0 : l.i1 < r.i1;
+              });
+
+    ColorConstraints(*topology);
+    BuildParticleAdjacency(*topology);
+
+    std::cout << "Soft body initialized: "
+              << restPositions.size() << " vertices, "
+              << constraints.size() << " constraints, "
+              << topology->GetColorCount() << " colors.\n";
+
+    return topology;
+}
+
+std::shared_ptr<const SoftBodyTopology> SoftBodyTopology::Load(const std::string& modelPath) {
+    AssetRegistry& registry = AssetRegistry::Instance();
+    return registry.GetTopology(registry.LoadMesh(modelPath));
+}
@@ -0,0 +1,85 @@
+#include "core/physics_system.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+void PhysicsSystem::CollectActiveBodies(Scene& scene) {
+    // The pool's dense array is exactly the set of bodies to step
+    ComponentRegistry& registry = scene.GetRegistry();
+    ComponentPool<SoftBody>& pool = registry.Pool<SoftBody>();
+
+    const size_t count = pool.Size();
+    activeBodies.resize(count);
+    bodyStepStats.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        activeBodies[i] = &pool.Components()[i];
+
+        const GameObject* object = registry.GetObject(pool.Entities()[i]);
+
+        BodyStepStats &stats = bodyStepStats[i];
+        stats.object = object->GetHandle();
+        stats.name = object->GetName();
+        stats.milliseconds = 0.0f;
+    }
+}
+
+int PhysicsSystem::Update(Scene& scene, float frameTime, JobSystem& jobs) {
+    timeAccumulator += frameTime;
+    if (timeAccumulator < fixedTimeStep) {
+        return 0;
+    }
+
+    CollectActiveBodies(scene);
+
+    int steps = 0;
+    while (timeAccumulator >= fixedTimeStep && steps < maxStepsPerFrame) {
+        StepBodies(fixedTimeStep, jobs);
+        timeAccumulator -= fixedTimeStep;
+        ++steps;
+    }
+
+    // A slow frame must not make the next one slower: forget what we could not catch up on
+    if (timeAccumulator >= fixedTimeStep) {
+        timeAccumulator = std::fmod(timeAccumulator, fixedTimeStep);
+    }
+
+    for (SoftBody *body : activeBodies) {
+        body->WritePositions();
+    }
+
+    return steps;
+}
+
+void PhysicsSystem::Step(Scene& scene, JobSystem& jobs, int steps) {
+    CollectActiveBodies(scene);
+
+    for (int i = 0; i < steps; ++i) {
+        StepBodies(fixedTimeStep, jobs);
+    }
+
+    for (SoftBody *body : activeBodies) {
+        body->WritePositions();
+    }
+}
+
+void PhysicsSystem::StepBodies(float dt, JobSystem& jobs) {
+    const int substepCount = std::max(1, substeps);
+    const float h = dt / static_cast<float>(substepCount);
+
+    // Bodies are independent, so the result does not depend on which thread
+    // steps which body; each task only writes its own stats slot. Large bodies
+    // split their constraint colors further, idle workers steal those chunks.
+    jobs.ParallelFor(activeBodies.size(), 1, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            const auto start = std::chrono::steady_clock::now();
+
+            for (int s = 0; s < substepCount; ++s) {
+                activeBodies[i]->Substep(h, gravity, 1, &jobs);
+            }
+
+            const std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            bodyStepStats[i].milliseconds += elapsed.count();
+        }
+    });
+}
@@ -0,0 +1,153 @@
+#include "core/scene_index.h"
+
+namespace {
+    const std::vector<ObjectHandle> kNoObjects;
+}
+
+void SceneIndex::Add(ObjectHandle handle, const std::string& name) {
+    if (handle.index >= objects.size()) {
+        objects.resize(handle.index + 1);
+    }
+    AddName(handle, name);
+}
+
+void SceneIndex::Remove(ObjectHandle handle) {
+    if (handle.index >= objects.size()) return;
+
+    RemoveName(handle);
+    while (!objects[handle.index].tags.empty()) {
+        RemoveTag(handle, objects[handle.index].tags.back().tag);
+    }
+}
+
+void SceneIndex::Rename(ObjectHandle handle, const std::string& name) {
+    ObjectEntry& entry = objects[handle.index];
+    if (entry.name != kNone && names[entry.name].text == name) return;
+
+    RemoveName(handle);
+    AddName(handle, name);
+}
+
+void SceneIndex::AddName(ObjectHandle handle, const std::string& name) {
+    auto it = nameIds.find(name);
+    if (it == nameIds.end()) {
+        uint32_t id;
+        if (!freeNames.empty()) {
+            id = freeNames.back();
+            freeNames.pop_back();
+        } else {
+            id = static_cast<uint32_t>(names.size());
+            names.emplace_back();
+            nameStamps.push_back(0);
+        }
+        names[id].text = name;
+        it = nameIds.emplace(name, id).first;
+        AddSuffixes(id);
+    }
+
+    NameEntry& entry = names[it->second];
+    objects[handle.index].name = it->second;
+    objects[handle.index].namePosition = static_cast<uint32_t>(entry.objects.size());
+    entry.objects.push_back(handle);
+}
+
+void SceneIndex::RemoveName(ObjectHandle handle) {
+    ObjectEntry& object = objects[handle.index];
+    if (object.name == kNone) return;
+
+    // Fill the hole with the name's last object
+    NameEntry& entry = names[object.name];
+    const ObjectHandle last = entry.objects.back();
+    entry.objects[object.namePosition] = last;
+    objects[last.index].namePosition = object.namePosition;
+    entry.objects.pop_back();
+
+    if (entry.objects.empty()) {
+        RemoveSuffixes(object.name);
+        nameIds.erase(entry.text);
+        entry.text.clear();
+        freeNames.push_back(object.name);
+    }
+    object.name = kNone;
+}
+
+const std::vector<ObjectHandle>& SceneIndex::FindByName(const std::string& name) const {
+    auto it = nameIds.find(name);
+    return it == nameIds.end() ? kNoObjects : names[it->second].objects;
+}
+
+TagId SceneIndex::InternTag(const std::string& tag) {
+    auto [it, inserted] = tagIds.try_emplace(tag, static_cast<TagId>(tagNames.size()));
+    if (inserted) {
+        tagNames.push_back(tag);
+        tagMembers.emplace_back();
+    }
+    return it->second;
+}
+
+TagId SceneIndex::FindTag(const std::string& tag) const {
+    auto it = tagIds.find(tag);
+    return it == tagIds.end() ? kNoTag : it->second;
+}
+
+bool SceneIndex::AddTag(ObjectHandle handle, TagId tag) {
+    if (HasTag(handle, tag)) return false;
+
+    auto& members = tagMembers[tag];
+    objects[handle.index].tags.push_back({tag, static_cast<uint32_t>(members.size())});
+    members.push_back(handle);
+    return true;
+}
+
+bool SceneIndex::RemoveTag(ObjectHandle handle, TagId tag) {
+    auto& tags = objects[handle.index].tags;
+    auto membership = std::find_if(tags.begin(), tags.end(), [tag](const TagMembership& m) { return m.tag == tag; });
+    if (membership == tags.end()) return false;
+
+    // Fill the hole with the tag's last object, whose own list is as short
+    auto& members = tagMembers[tag];
+    const ObjectHandle last = members.back();
+    members[membership->position] = last;
+    for (TagMembership& moved : objects[last.index].tags) {
+        if (moved.tag == tag) moved.position = membership->position;
+    }
+    members.pop_back();
+
+    *membership = tags.back();
+    tags.pop_back();
+    return true;
+}
+
+bool SceneIndex::HasTag(ObjectHandle handle, TagId tag) const {
+    if (handle.index >= objects.size()) return false;
+
+    // Objects carry a handful of tags, a scan beats a set
+    for (const TagMembership& membership : objects[handle.index].tags) {
+        if (membership.tag == tag) return true;
+    }
+    return false;
+}
+
+const std::vector<ObjectHandle>& SceneIndex::FindByTag(TagId tag) const {
+    return tag < tagMembers.size() ? tagMembers[tag] : kNoObjects;
+}
+
+void SceneIndex::AddSuffixes(uint32_t name) {
+    const auto length = static_cast<uint32_t>(names[name].text.size());
+    for (uint32_t offset = 0; offset < length; ++offset) {
+        suffixes.insert({name, offset});
+    }
+}
+
+void SceneIndex::RemoveSuffixes(uint32_t name) {
+    const auto length = static_cast<uint32_t>(names[name].text.size());
+    for (uint32_t offset = 0; offset < length; ++offset) {
+        suffixes.erase({name, offset});
+    }
+}
+
+bool SceneIndex::Visit(uint32_t name) const {
+    if (nameStamps[name] == searchStamp) return false;
+    nameStamps[name] = searchStamp;
+    return true;
+}
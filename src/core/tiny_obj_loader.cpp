@@ -0,0 +1,4 @@
+// The one translation unit that compiles the tinyobjloader implementation.
+// It lives in the core library so tools without a window can load meshes too.
+#define TINYOBJLOADER_IMPLEMENTATION
+#include "render/tiny_obj_loader.h"
@@ -0,0 +1,289 @@
+#include "core/transform_batch.h"
+
+#include "core/physics/simd_kernels.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define TRANSFORM_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#define TRANSFORM_TARGET_AVX2
+#else
+#define TRANSFORM_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#endif
+#endif
+
+// The kernels store whole columns with float pointers
+static_assert(sizeof(TransformMatrices) == 32 * sizeof(float), "TransformMatrices must be two packed mat4s");
+
+void TrsList::Clear() {
+    count = 0;
+    for (auto* array : {&px, &py, &pz, &rx, &ry, &rz, &sx, &sy, &sz}) array->clear();
+}
+
+void TrsList::Add(const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale) {
+    // Replace the padding (or grow it by a full block of identities)
+    if (count == px.size()) {
+        for (auto* array : {&px, &py, &pz, &rx, &ry, &rz}) array->resize(count + kLanes, 0.0f);
+        for (auto* array : {&sx, &sy, &sz}) array->resize(count + kLanes, 1.0f);
+    }
+    px[count] = position.x; py[count] = position.y; pz[count] = position.z;
+    rx[count] = rotation.x; ry[count] = rotation.y; rz[count] = rotation.z;
+    sx[count] = scale.x; sy[count] = scale.y; sz[count] = scale.z;
+    ++count;
+}
+
+namespace {
+
+    // Column c of the matrix, then of the inverse transpose, as float offsets
+    // into a TransformMatrices
+    constexpr size_t kMatrixColumn[4] = {0, 4, 8, 12};
+    constexpr size_t kNormalColumn[4] = {16, 20, 24, 28};
+
+    constexpr float kDegToRad = 0.017453292519943295f;
+
+    // With R = rotX(a) * rotY(b) * rotZ(c) (columns R0, R1, R2) and S the
+    // scale, the matrix is [R*S | t] and its inverse transpose has columns
+    // (Rj / sj, -dot(Rj, t) / sj) and (0, 0, 0, 1).
+
+    // ---------------------------------------------------------------- scalar
+
+    void ComposeScalar(const TrsList& l, size_t i, float* out) {
+        const float sa = std::sin(l.rx[i] * kDegToRad), ca = std::cos(l.rx[i] * kDegToRad);
+        const float sb = std::sin(l.ry[i] * kDegToRad), cb = std::cos(l.ry[i] * kDegToRad);
+        const float sc = std::sin(l.rz[i] * kDegToRad), cc = std::cos(l.rz[i] * kDegToRad);
+
+        const float r[3][3] = {
+            {cb * cc, sa * sb * cc + ca * sc, sa * sc - ca * sb * cc},
+            {-cb * sc, ca * cc - sa * sb * sc, sa * cc + ca * sb * sc},
+            {sb, -sa * cb, ca * cb},
+        };
+        const float t[3] = {l.px[i], l.py[i], l.pz[i]};
+        const float s[3] = {l.sx[i], l.sy[i], l.sz[i]};
+
+        for (int c = 0; c < 3; ++c) {
+            const float inv = 1.0f / s[c];
+            float* m = out + kMatrixColumn[c];
+            float* n = out + kNormalColumn[c];
+            m[0] = r[c][0] * s[c]; m[1] = r[c][1] * s[c]; m[2] = r[c][2] * s[c]; m[3] = 0.0f;
+            n[0] = r[c][0] * inv; n[1] = r[c][1] * inv; n[2] = r[c][2] * inv;
+            n[3] = -(r[c][0] * t[0] + r[c][1] * t[1] + r[c][2] * t[2]) * inv;
+        }
+        float* m = out + kMatrixColumn[3];
+        float* n = out + kNormalColumn[3];
+        m[0] = t[0]; m[1] = t[1]; m[2] = t[2]; m[3] = 1.0f;
+        n[0] = 0.0f; n[1] = 0.0f; n[2] = 0.0f; n[3] = 1.0f;
+    }
+
+#ifdef TRANSFORM_SIMD_X86
+
+    // sin and cos on each lane: x = q * pi/2 + r with |r| <= pi/4 (pi/2 split
+    // in three so q * pi/2 is exact), minimax polynomials on r, then q picks
+    // the quadrant. Good to a few ulp for any angle a transform would use.
+    constexpr float kTwoOverPi = 0.636619772367581343f;
+    constexpr float kHalfPi1 = 1.5703125f;
+    constexpr float kHalfPi2 = 4.837512969970703125e-4f;
+    constexpr float kHalfPi3 = 7.54978995489188216e-8f;
+    constexpr float kSin1 = -1.6666654611e-1f, kSin2 = 8.3321608736e-3f, kSin3 = -1.9515295891e-4f;
+    constexpr float kCos1 = 4.166664568298827e-2f, kCos2 = -1.388731625493765e-3f, kCos3 = 2.443315711809948e-5f;
+
+    // ------------------------------------------------------------------ SSE2
+
+    inline __m128 Select128(__m128 a, __m128 b, __m128 mask) {
+        return _mm_or_ps(_mm_and_ps(mask, b), _mm_andnot_ps(mask, a));
+    }
+
+    inline void SinCos128(__m128 x, __m128& sinOut, __m128& cosOut) {
+        const __m128i q = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(kTwoOverPi)));
+        const __m128 qf = _mm_cvtepi32_ps(q);
+        __m128 r = _mm_sub_ps(x, _mm_mul_ps(qf, _mm_set1_ps(kHalfPi1)));
+        r = _mm_sub_ps(r, _mm_mul_ps(qf, _mm_set1_ps(kHalfPi2)));
+        r = _mm_sub_ps(r, _mm_mul_ps(qf, _mm_set1_ps(kHalfPi3)));
+        const __m128 r2 = _mm_mul_ps(r, r);
+
+        __m128 s = _mm_add_ps(_mm_mul_ps(r2, _mm_set1_ps(kSin3)), _mm_set1_ps(kSin2));
+        s = _mm_add_ps(_mm_mul_ps(r2, s), _mm_set1_ps(kSin1));
+        s = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(r2, r), s));
+
+        __m128 c = _mm_add_ps(_mm_mul_ps(r2, _mm_set1_ps(kCos3)), _mm_set1_ps(kCos2));
+        c = _mm_add_ps(_mm_mul_ps(r2, c), _mm_set1_ps(kCos1));
+        c = _mm_add_ps(_mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(r2, _mm_set1_ps(0.5f))),
+                       _mm_mul_ps(_mm_mul_ps(r2, r2), c));
+
+        // Odd quadrants swap sin and cos; bit 1 of q (of q + 1 for cos) flips the sign
+        const __m128i one = _mm_set1_epi32(1), two = _mm_set1_epi32(2);
+        const __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, one), one));
+        const __m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(q, two), 30));
+        const __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(q, one), two), 30));
+        sinOut = _mm_xor_ps(Select128(s, c, swap), sinSign);
+        cosOut = _mm_xor_ps(Select128(c, s, swap), cosSign);
+    }
+
+    // Lane k of x, y, z, w is column `offset` of out[k]
+    inline void StoreColumn128(__m128 x, __m128 y, __m128 z, __m128 w, float* out, size_t offset) {
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+        _mm_storeu_ps(out + offset, x);
+        _mm_storeu_ps(out + 32 + offset, y);
+        _mm_storeu_ps(out + 64 + offset, z);
+        _mm_storeu_ps(out + 96 + offset, w);
+    }
+
+    void ComposeSSE2(const TrsList& l, size_t i, float* out) {
+        const __m128 deg = _mm_set1_ps(kDegToRad);
+        __m128 sa, ca, sb, cb, sc, cc;
+        SinCos128(_mm_mul_ps(_mm_loadu_ps(l.rx.data() + i), deg), sa, ca);
+        SinCos128(_mm_mul_ps(_mm_loadu_ps(l.ry.data() + i), deg), sb, cb);
+        SinCos128(_mm_mul_ps(_mm_loadu_ps(l.rz.data() + i), deg), sc, cc);
+
+        const __m128 sasb = _mm_mul_ps(sa, sb), casb = _mm_mul_ps(ca, sb);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 r[3][3] = {
+            {_mm_mul_ps(cb, cc), _mm_add_ps(_mm_mul_ps(sasb, cc), _mm_mul_ps(ca, sc)),
+             _mm_sub_ps(_mm_mul_ps(sa, sc), _mm_mul_ps(casb, cc))},
+            {_mm_sub_ps(zero, _mm_mul_ps(cb, sc)), _mm_sub_ps(_mm_mul_ps(ca, cc), _mm_mul_ps(sasb, sc)),
+             _mm_add_ps(_mm_mul_ps(sa, cc), _mm_mul_ps(casb, sc))},
+            {sb, _mm_sub_ps(zero, _mm_mul_ps(sa, cb)), _mm_mul_ps(ca, cb)},
+        };
+        const __m128 t[3] = {_mm_loadu_ps(l.px.data() + i), _mm_loadu_ps(l.py.data() + i), _mm_loadu_ps(l.pz.data() + i)};
+        const __m128 s[3] = {_mm_loadu_ps(l.sx.data() + i), _mm_loadu_ps(l.sy.data() + i), _mm_loadu_ps(l.sz.data() + i)};
+
+        const __m128 one = _mm_set1_ps(1.0f);
+        for (int c = 0; c < 3; ++c) {
+            const __m128 inv = _mm_div_ps(one, s[c]);
+            const __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(r[c][0], t[0]), _mm_mul_ps(r[c][1], t[1])),
+                                        _mm_mul_ps(r[c][2], t[2]));
+            StoreColumn128(_mm_mul_ps(r[c][0], s[c]), _mm_mul_ps(r[c][1], s[c]), _mm_mul_ps(r[c][2], s[c]), zero,
+                           out, kMatrixColumn[c]);
+            StoreColumn128(_mm_mul_ps(r[c][0], inv), _mm_mul_ps(r[c][1], inv), _mm_mul_ps(r[c][2], inv),
+                           _mm_sub_ps(zero, _mm_mul_ps(d, inv)), out, kNormalColumn[c]);
+        }
+        StoreColumn128(t[0], t[1], t[2], one, out, kMatrixColumn[3]);
+        StoreColumn128(zero, zero, zero, one, out, kNormalColumn[3]);
+    }
+
+    // ------------------------------------------------------------------ AVX2
+
+    TRANSFORM_TARGET_AVX2
+    inline void SinCos256(__m256 x, __m256& sinOut, __m256& cosOut) {
+        const __m256i q = _mm256_cvtps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(kTwoOverPi)));
+        const __m256 qf = _mm256_cvtepi32_ps(q);
+        __m256 r = _mm256_fnmadd_ps(qf, _mm256_set1_ps(kHalfPi1), x);
+        r = _mm256_fnmadd_ps(qf, _mm256_set1_ps(kHalfPi2), r);
+        r = _mm256_fnmadd_ps(qf, _mm256_set1_ps(kHalfPi3), r);
+        const __m256 r2 = _mm256_mul_ps(r, r);
+
+        __m256 s = _mm256_fmadd_ps(r2, _mm256_set1_ps(kSin3), _mm256_set1_ps(kSin2));
+        s = _mm256_fmadd_ps(r2, s, _mm256_set1_ps(kSin1));
+        s = _mm256_fmadd_ps(_mm256_mul_ps(r2, r), s, r);
+
+        __m256 c = _mm256_fmadd_ps(r2, _mm256_set1_ps(kCos3), _mm256_set1_ps(kCos2));
+        c = _mm256_fmadd_ps(r2, c, _mm256_set1_ps(kCos1));
+        c = _mm256_fmadd_ps(_mm256_mul_ps(r2, r2), c, _mm256_fnmadd_ps(r2, _mm256_set1_ps(0.5f), _mm256_set1_ps(1.0f)));
+
+        const __m256i one = _mm256_set1_epi32(1), two = _mm256_set1_epi32(2);
+        const __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(q, one), one));
+        const __m256 sinSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(q, two), 30));
+        const __m256 cosSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(q, one), two), 30));
+        sinOut = _mm256_xor_ps(_mm256_blendv_ps(s, c, swap), sinSign);
+        cosOut = _mm256_xor_ps(_mm256_blendv_ps(c, s, swap), cosSign);
+    }
+
+    // Transposes each 128 bit half on its own: lane k's column comes out in
+    // the low half of columns[k % 4], lane k + 4's in the high half
+    TRANSFORM_TARGET_AVX2
+    inline void Transpose256(__m256 x, __m256 y, __m256 z, __m256 w, __m256 columns[4]) {
+        const __m256 xy0 = _mm256_unpacklo_ps(x, y), xy1 = _mm256_unpackhi_ps(x, y);
+        const __m256 zw0 = _mm256_unpacklo_ps(z, w), zw1 = _mm256_unpackhi_ps(z, w);
+        columns[0] = _mm256_shuffle_ps(xy0, zw0, _MM_SHUFFLE(1, 0, 1, 0));
+        columns[1] = _mm256_shuffle_ps(xy0, zw0, _MM_SHUFFLE(3, 2, 3, 2));
+        columns[2] = _mm256_shuffle_ps(xy1, zw1, _MM_SHUFFLE(1, 0, 1, 0));
+        columns[3] = _mm256_shuffle_ps(xy1, zw1, _MM_SHUFFLE(3, 2, 3, 2));
+    }
+
+    // Columns `offset` and `offset` + 4 of all eight lanes, one 256 bit store
+    // per lane
+    TRANSFORM_TARGET_AVX2
+    inline void StoreColumnPair256(const __m256 a[4], const __m256 b[4], float* out, size_t offset) {
+        for (int k = 0; k < 4; ++k) {
+            _mm256_storeu_ps(out + 32 * k + offset, _mm256_permute2f128_ps(a[k], b[k], 0x20));
+            _mm256_storeu_ps(out + 32 * (k + 4) + offset, _mm256_permute2f128_ps(a[k], b[k], 0x31));
+        }
+    }
+
+    TRANSFORM_TARGET_AVX2
+    void ComposeAVX2(const TrsList& l, size_t i, float* out) {
+        const __m256 deg = _mm256_set1_ps(kDegToRad);
+        __m256 sa, ca, sb, cb, sc, cc;
+        SinCos256(_mm256_mul_ps(_mm256_loadu_ps(l.rx.data() + i), deg), sa, ca);
+        SinCos256(_mm256_mul_ps(_mm256_loadu_ps(l.ry.data() + i), deg), sb, cb);
+        SinCos256(_mm256_mul_ps(_mm256_loadu_ps(l.rz.data() + i), deg), sc, cc);
+
+        const __m256 sasb = _mm256_mul_ps(sa, sb), casb = _mm256_mul_ps(ca, sb);
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 r[3][3] = {
+            {_mm256_mul_ps(cb, cc), _mm256_fmadd_ps(sasb, cc, _mm256_mul_ps(ca, sc)),
+             _mm256_fnmadd_ps(casb, cc, _mm256_mul_ps(sa, sc))},
+            {_mm256_sub_ps(zero, _mm256_mul_ps(cb, sc)), _mm256_fnmadd_ps(sasb, sc, _mm256_mul_ps(ca, cc)),
+             _mm256_fmadd_ps(casb, sc, _mm256_mul_ps(sa, cc))},
+            {sb, _mm256_sub_ps(zero, _mm256_mul_ps(sa, cb)), _mm256_mul_ps(ca, cb)},
+        };
+        const __m256 t[3] = {_mm256_loadu_ps(l.px.data() + i), _mm256_loadu_ps(l.py.data() + i),
+                             _mm256_loadu_ps(l.pz.data() + i)};
+        const __m256 s[3] = {_mm256_loadu_ps(l.sx.data() + i), _mm256_loadu_ps(l.sy.data() + i),
+                             _mm256_loadu_ps(l.sz.data() + i)};
+
+        const __m256 one = _mm256_set1_ps(1.0f);
+        __m256 matrix[4][4], normal[4][4];
+        for (int c = 0; c < 3; ++c) {
+            const __m256 inv = _mm256_div_ps(one, s[c]);
+            const __m256 d = _mm256_fmadd_ps(r[c][2], t[2], _mm256_fmadd_ps(r[c][1], t[1], _mm256_mul_ps(r[c][0], t[0])));
+            Transpose256(_mm256_mul_ps(r[c][0], s[c]), _mm256_mul_ps(r[c][1], s[c]), _mm256_mul_ps(r[c][2], s[c]),
+                         zero, matrix[c]);
+            Transpose256(_mm256_mul_ps(r[c][0], inv), _mm256_mul_ps(r[c][1], inv), _mm256_mul_ps(r[c][2], inv),
+                         _mm256_sub_ps(zero, _mm256_mul_ps(d, inv)), normal[c]);
+        }
+        Transpose256(t[0], t[1], t[2], one, matrix[3]);
+        // The last normal column is (0, 0, 0, 1) for every lane
+        const __m256 unitW = _mm256_setr_ps(0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f);
+        for (__m256& column : normal[3]) column = unitW;
+
+        StoreColumnPair256(matrix[0], matrix[1], out, kMatrixColumn[0]);
+        StoreColumnPair256(matrix[2], matrix[3], out, kMatrixColumn[2]);
+        StoreColumnPair256(normal[0], normal[1], out, kNormalColumn[0]);
+        StoreColumnPair256(normal[2], normal[3], out, kNormalColumn[2]);
+    }
+
+    // A group at a time straight into `matrices`; the last, partial group
+    // goes through a scratch block so nothing is written past Size()
+    template <size_t Width, typename Kernel>
+    void ComposeGroups(const TrsList& list, TransformMatrices* matrices, Kernel kernel) {
+        const size_t n = list.Size();
+        size_t i = 0;
+        for (; i + Width <= n; i += Width) {
+            kernel(list, i, reinterpret_cast<float*>(matrices + i));
+        }
+        if (i < n) {
+            TransformMatrices scratch[Width];
+            kernel(list, i, reinterpret_cast<float*>(scratch));
+            std::copy(scratch, scratch + (n - i), matrices + i);
+        }
+    }
+
+#endif // TRANSFORM_SIMD_X86
+
+}
+
+void ComposeTransforms(const TrsList& list, TransformMatrices* matrices) {
+    switch (simd::ActiveSet()) {
+#ifdef TRANSFORM_SIMD_X86
+        case simd::InstructionSet::AVX2: ComposeGroups<8>(list, matrices, ComposeAVX2); return;
+        case simd::InstructionSet::SSE2: ComposeGroups<4>(list, matrices, ComposeSSE2); return;
+#endif
+        default:
+            for (size_t i = 0; i < list.Size(); ++i) {
+                ComposeScalar(list, i, reinterpret_cast<float*>(matrices + i));
+            }
+    }
+}
@@ -0,0 +1,160 @@
+#include "core/transform_hierarchy.h"
+
+#include <algorithm>
+
+namespace {
+    const std::vector<ObjectHandle> kNoChildren;
+
+    void Unlink(std::vector<ObjectHandle>& children, ObjectHandle child) {
+        auto it = std::find(children.begin(), children.end(), child);
+        if (it != children.end()) {
+            *it = children.back();
+            children.pop_back();
+        }
+    }
+}
+
+TransformHierarchy::Node& TransformHierarchy::NodeOf(ObjectHandle handle) {
+    if (handle.index >= nodes.size()) {
+        nodes.resize(handle.index + 1);
+    }
+    return nodes[handle.index];
+}
+
+bool TransformHierarchy::SetParent(ObjectHandle child, ObjectHandle parent) {
+    // Refuse cycles: parent must not be child or below it
+    for (ObjectHandle up = parent; up.index != SlotHandle::kNoIndex; up = GetParent(up)) {
+        if (up == child) return false;
+    }
+
+    // Grow the table first so node stays valid
+    if (parent.index != SlotHandle::kNoIndex) NodeOf(parent);
+    Node& node = NodeOf(child);
+    if (node.parent == parent) return true;
+
+    if (node.parent.index != SlotHandle::kNoIndex) {
+        Unlink(NodeOf(node.parent).children, child);
+    }
+    node.parent = parent;
+    if (parent.index != SlotHandle::kNoIndex) {
+        NodeOf(parent).children.push_back(child);
+    }
+
+    relinked.push_back(child.index);
+    orderDirty = true;
+    return true;
+}
+
+ObjectHandle TransformHierarchy::GetParent(ObjectHandle handle) const {
+    return handle.index < nodes.size() ? nodes[handle.index].parent : ObjectHandle{};
+}
+
+const std::vector<ObjectHandle>& TransformHierarchy::GetChildren(ObjectHandle handle) const {
+    return handle.index < nodes.size() ? nodes[handle.index].children : kNoChildren;
+}
+
+void TransformHierarchy::Remove(ObjectHandle handle) {
+    if (handle.index >= nodes.size()) return;
+
+    Node& node = nodes[handle.index];
+    if (node.parent.index == SlotHandle::kNoIndex && node.children.empty()) return;
+
+    if (node.parent.index != SlotHandle::kNoIndex) {
+        Unlink(NodeOf(node.parent).children, handle);
+    }
+    for (ObjectHandle child : node.children) {
+        nodes[child.index].parent = ObjectHandle{};
+        relinked.push_back(child.index);
+    }
+
+    node = Node{};
+    orderDirty = true;
+}
+
+void TransformHierarchy::BuildOrder() {
+    orderDirty = false;
+    order.clear();
+
+    // Depth of every object with a parent, from the chain above it
+    std::vector<std::pair<uint32_t, Entity>> depths;
+    for (Entity entity = 0; entity < nodes.size(); ++entity) {
+        if (nodes[entity].parent.index == SlotHandle::kNoIndex) continue;
+
+        uint32_t depth = 0;
+        for (ObjectHandle up = nodes[entity].parent; up.index != SlotHandle::kNoIndex; up = nodes[up.index].parent) {
+            ++depth;
+        }
+        depths.push_back({depth, entity});
+    }
+
+    std::sort(depths.begin(), depths.end());
+    order.reserve(depths.size());
+    for (const auto& [depth, entity] : depths) {
+        order.push_back(entity);
+    }
+}
+
+void TransformHierarchy::UpdateWorld(Transform& transform, const Transform& parent) {
+    // (P * L)^-T = P^-T * L^-T, so no inverse is needed here
+    transform.worldMatrix = parent.worldMatrix * transform.localMatrix;
+    transform.worldInverseTranspose = parent.worldInverseTranspose * transform.localInverseTranspose;
+}
+
+void TransformHierarchy::Update(ComponentRegistry& registry) {
+    if (orderDirty) BuildOrder();
+
+    ComponentPool<Transform>& transforms = registry.Pool<Transform>();
+
+    // A new parent means a new world matrix even if nothing else changed
+    for (Entity entity : relinked) {
+        if (Transform* transform = transforms.Get(entity)) transform->dirty = true;
+    }
+    relinked.clear();
+
+    changed.resize(std::max(nodes.size(), registry.GetEntityCount()), 0);
+
+    // Local matrices do not depend on the parent, so every dirty transform
+    // goes through the SIMD batch at once
+    dirtyTrs.Clear();
+    dirtyTransforms.clear();
+    const auto& entities = transforms.Entities();
+    auto& components = transforms.Components();
+    for (size_t i = 0; i < components.size(); ++i) {
+        Transform& transform = components[i];
+        changed[entities[i]] = transform.dirty;
+        if (!transform.dirty) continue;
+
+        dirtyTrs.Add(transform.position, transform.rotation, transform.scale);
+        dirtyTransforms.push_back(&transform);
+    }
+
+    dirtyMatrices.resize(dirtyTransforms.size());
+    ComposeTransforms(dirtyTrs, dirtyMatrices.data());
+
+    // World = local for roots; children are overwritten below
+    for (size_t i = 0; i < dirtyTransforms.size(); ++i) {
+        Transform& transform = *dirtyTransforms[i];
+        transform.localMatrix = transform.worldMatrix = dirtyMatrices[i].matrix;
+        transform.localInverseTranspose = transform.worldInverseTranspose = dirtyMatrices[i].inverseTranspose;
+        transform.dirty = false;
+    }
+
+    // Then every child, after its parent
+    const Transform identity;
+    for (Entity entity : order) {
+        Transform* transform = transforms.Get(entity);
+        if (!transform) {
+            changed[entity] = 0;
+            continue;
+        }
+
+        const Entity parent = nodes[entity].parent.index;
+        const Transform* parentTransform = transforms.Get(parent);
+        const bool parentChanged = parentTransform && changed[parent];
+
+        changed[entity] = changed[entity] || parentChanged;
+        if (!changed[entity]) continue;
+
+        UpdateWorld(*transform, parentTransform ? *parentTransform : identity);
+    }
+}
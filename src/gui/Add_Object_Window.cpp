@@ -62,20 +62,15 @@ void AddObjectWindow::showAddObjectWindow(MainEngine *engine, bool &ShowAddObjec
                 }
                 break;
             case 2: {
-                const auto light1 = std::make_shared<GameObject>();
-                const auto lightTransform1 = std::make_shared<Transform>(
+                GameObject* light1 = engine->GetCurrScene()->GetObject(engine->GetCurrScene()->CreateLight());
+                light1->SetComponent(Transform(
                     glm::vec3(0.0f, 0.0f, 3.0f),
                     glm::vec3(0.0f, 0.0f, 0.0f),
-                    glm::vec3(0.0f, 0.0f, 0.0f));
+                    glm::vec3(0.0f, 0.0f, 0.0f)));
 
-                const auto lightComp1 = std::make_shared<PointLight>(
+                light1->SetComponent(PointLight(
                     glm::vec3(0.5f, 0.5f, 0.5f),
-                        1.0f);
-
-                light1->components[TRANSFORM] = lightTransform1;
-                light1->components[LIGHT] = lightComp1;
-
-                engine->GetCurrScene()->GetLights().emplace_back(light1);
+                        1.0f));
                 break;
             }
             case 3: {
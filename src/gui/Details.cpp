@@ -7,66 +7,92 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
-void ShowTransform(std::shared_ptr<Transform> &object_transform){
+void ShowTransform(Transform &object_transform){
     if (ImGui::TreeNode("Transform")){
         ImGui::Text("Position");
         ImGui::SameLine();
-        ImGui::DragFloat3("##Position", &object_transform->position[0], 0.001f, 0.0f, 0.0f, "%.3f");
+        // Edit copies and write back through the setters, which mark the
+        // transform dirty
+        glm::vec3 position = object_transform.GetPosition();
+        if(ImGui::DragFloat3("##Position", &position[0], 0.001f, 0.0f, 0.0f, "%.3f")) {
+            object_transform.SetPosition(position);
+        }
 
         ImGui::Text("Rotation");
         ImGui::SameLine();
-        ImGui::DragFloat3("##Rotation", &object_transform->rotation[0], 0.001f * 5.f, 0.0f, 0.0f, "%.3f");
+        glm::vec3 rotation = object_transform.GetRotation();
+        if(ImGui::DragFloat3("##Rotation", &rotation[0], 0.001f * 5.f, 0.0f, 0.0f, "%.3f")) {
+            object_transform.SetRotation(rotation);
+        }
 
         ImGui::Text("Scale");
         ImGui::SameLine();
-        ImGui::DragFloat3("##Scale", &object_transform->scale[0], 0.001f, 0.0f, 0.0f, "%.3f");
+        glm::vec3 scale = object_transform.GetScale();
+        if(ImGui::DragFloat3("##Scale", &scale[0], 0.001f, 0.0f, 0.0f, "%.3f")) {
+            object_transform.SetScale(scale);
+        }
 
         ImGui::TreePop();
     }
 }
 
-void ShowMaterial(std::shared_ptr<Material> &object_material) {
+void ShowMaterial(Material &object_material) {
     if (ImGui::TreeNode("Material")){
         ImGui::Text("Ambient");
         ImGui::SameLine();
-        ImGui::ColorEdit3("##Ambient", &object_material->ambient[0]);
+        ImGui::ColorEdit3("##Ambient", &object_material.ambient[0]);
 
         ImGui::Text("Diffuse");
         ImGui::SameLine();
-        ImGui::ColorEdit3("##Diffuse", &object_material->diffuse[0]);
+        ImGui::ColorEdit3("##Diffuse", &object_material.diffuse[0]);
 
         ImGui::Text("Specular");
         ImGui::SameLine();
-        ImGui::ColorEdit3("##Specular", &object_material->specular[0]);
+        ImGui::ColorEdit3("##Specular", &object_material.specular[0]);
 
         ImGui::Text("Shininess");
         ImGui::SameLine();
-        ImGui::DragFloat("##Shininess", &object_material->shininess, 0.1f, 0.0f, 0.0f, "%.1f", ImGuiSliderFlags_AlwaysClamp);
-        object_material->shininess = std::max(0.f, object_material->shininess);
+        ImGui::DragFloat("##Shininess", &object_material.shininess, 0.1f, 0.0f, 0.0f, "%.1f", ImGuiSliderFlags_AlwaysClamp);
+        object_material.shininess = std::max(0.f, object_material.shininess);
 
         ImGui::TreePop();
     }
 }
 
-void ShowLight(std::shared_ptr<PointLight> &object_light) {
+void ShowLight(PointLight &object_light) {
     if (ImGui::TreeNode("Light")) {
         ImGui::Text("Color");
         ImGui::SameLine();
-        ImGui::ColorPicker3("##Color", &object_light->color[0]);
+        ImGui::ColorPicker3("##Color", &object_light.color[0]);
         ImGui::TreePop();
     }
 }
 
-void DeleteObject(const std::shared_ptr<Scene>& scene) {
-    if (scene->selectedGameObj) {
-        auto& Objects = scene->mOrL ? scene->GetModels() : scene->GetLights();
-
-        auto it = std::find(Objects.begin(), Objects.end(), scene->selectedGameObj);
-        if (it != Objects.end()) {
-            Objects.erase(it);
-            scene->selectedGameObj.reset();
-            scene->selectedGameObj = nullptr;
+void ShowSoftBody(SoftBody &object_softbody) {
+    if (ImGui::TreeNode("Soft Body")) {
+        const char* modes[] = { "Gauss-Seidel", "Jacobi" };
+        int mode = static_cast<int>(object_softbody.solverMode);
+        ImGui::Text("Solver");
+        ImGui::SameLine();
+        if (ImGui::Combo("##Solver", &mode, modes, IM_ARRAYSIZE(modes))) {
+            object_softbody.solverMode = static_cast<SolverMode>(mode);
         }
+
+        if (object_softbody.solverMode == SolverMode::Jacobi) {
+            ImGui::Text("Relaxation");
+            ImGui::SameLine();
+            ImGui::DragFloat("##Relaxation", &object_softbody.jacobiRelaxation, 0.01f, 0.1f, 2.0f, "%.2f", ImGuiSliderFlags_AlwaysClamp);
+        }
+
+        ImGui::Text("%zu particles, %zu constraints", object_softbody.particles.Size(), object_softbody.topology->constraints.size());
+        ImGui::TreePop();
+    }
+}
+
+void DeleteObject(const std::shared_ptr<Scene>& scene) {
+    if (scene->GetObject(scene->selectedGameObj)) {
+        scene->DestroyObject(scene->selectedGameObj);
+        scene->selectedGameObj = ObjectHandle{};
     } else {
         auto& Cameras = scene->GetCameras();
 
@@ -81,7 +107,7 @@ void DeleteObject(const std::shared_ptr<Scene>& scene) {
 }
 
 void ShowComponentControl(const std::shared_ptr<Scene> &scene) {
-    std::shared_ptr<GameObject> gameObject = scene->selectedGameObj;
+    GameObject* gameObject = scene->GetObject(scene->selectedGameObj);
     // ImGui::Text("Number of Components: %d", gameObject->GetComponentCount());
 
     // Make it so that Light component cannot be taken off of lights
@@ -123,7 +149,7 @@ void ShowComponentControl(const std::shared_ptr<Scene> &scene) {
     static int currentObject = 0;
     static COMPONENT_TYPE type = NUM_ENUM;
     static std::vector<std::string> gameObjectNames = {"Select Object"};
-    static std::shared_ptr<GameObject> copyObject;
+    static ObjectHandle copyObject;
 
 
     // Dropdown for selecting the component to copy
@@ -135,7 +161,7 @@ void ShowComponentControl(const std::shared_ptr<Scene> &scene) {
         gameObjectNames.clear();
         gameObjectNames.push_back("Select Object");
         currentObject = 0; 
-        copyObject = nullptr;
+        copyObject = ObjectHandle{};
 
         switch(currentComponent) {
             case 0: type = NUM_ENUM; break;
@@ -145,16 +171,9 @@ void ShowComponentControl(const std::shared_ptr<Scene> &scene) {
             case 4: type = SOFTBODY; break;
         }
         if(type != NUM_ENUM) {
-            for(const auto& model : scene->GetModels()) {
-                if(model->GetComponent(type)) {
-                    gameObjectNames.push_back(model->name);
-                }
-            }
-            for(const auto& light : scene->GetLights()) {
-                if(light->GetComponent(type)) {
-                    gameObjectNames.push_back(light->name);
-                }
-            }
+            scene->ForEachWithComponents(MaskOf(type), [&](ObjectHandle handle) {
+                gameObjectNames.push_back(scene->GetObject(handle)->GetName());
+            });
         }
     }
 
@@ -173,18 +192,20 @@ void ShowComponentControl(const std::shared_ptr<Scene> &scene) {
                 
                     
                 // Change to search by id probably
-                auto results = scene->SearchByName(gameObjectNames[currentObject]);
+                const auto& results = scene->FindByName(gameObjectNames[currentObject]);
                 if (!results.empty()) {
                     copyObject = results.front();
                 }
                 if(currentObject == 0) {
-                    copyObject = nullptr;
+                    copyObject = ObjectHandle{};
                 }
             }
         }
-            if(copyObject && type != NUM_ENUM) {
+    // The source may have been deleted since it was picked
+    const GameObject* source = scene->GetObject(copyObject);
+    if(source && source->GetComponent(type) && type != NUM_ENUM) {
         if(ImGui::Button("Confirm")) {
-            gameObject->components[type] = copyObject->GetComponent(type)->Clone();
+            gameObject->CopyComponent(source->GetComponent(type));
         }
     }
     // ImGui::Text("Current Object Index: %d", currentObject);
@@ -253,10 +274,9 @@ void Details::ShowDetails(const std::shared_ptr<Scene>& scene)
                 DeleteObject(scene);
             }
         }
-        else if(scene->selectedGameObj)
+        else if(GameObject* object = scene->GetObject(scene->selectedGameObj))
         {
-            std::shared_ptr<GameObject> object = scene->selectedGameObj;
-            if(auto objectName = &object->name)
+            if(auto objectName = &object->GetName())
             {
                 char nameBuffer[128];
                 strncpy(nameBuffer, objectName->c_str(), sizeof(nameBuffer));
@@ -264,25 +284,21 @@ void Details::ShowDetails(const std::shared_ptr<Scene>& scene)
                 ImGui::Text("Name");
                 ImGui::SameLine();
                 if(ImGui::InputText("##Name", nameBuffer, sizeof(nameBuffer))) {
-                    object->name = nameBuffer;
+                    scene->SetObjectName(object->GetHandle(), nameBuffer);
                 }
             }
 
-            for(const auto& objComponent : object->components) {
-
-                // Try to cast component to a transform
-                if(auto objTransform = std::dynamic_pointer_cast<Transform>( objComponent ))
-                {
-                    ShowTransform(objTransform);
-                }
-                // Try to cast component to a Material
-                if(auto objMaterial = std::dynamic_pointer_cast<Material>( objComponent ))
-                {
-                    ShowMaterial(objMaterial);
-                }
-                if(auto objLight = std::dynamic_pointer_cast<PointLight>( objComponent )) {
-                    ShowLight(objLight);
-                }
+            if(Transform* objTransform = object->GetComponent<Transform>()) {
+                ShowTransform(*objTransform);
+            }
+            if(Material* objMaterial = object->GetComponent<Material>()) {
+                ShowMaterial(*objMaterial);
+            }
+            if(PointLight* objLight = object->GetComponent<PointLight>()) {
+                ShowLight(*objLight);
+            }
+            if(SoftBody* objSoftBody = object->GetComponent<SoftBody>()) {
+                ShowSoftBody(*objSoftBody);
             }
             if(ImGui::TreeNode("Component Control")) {
                 ShowComponentControl(scene);
@@ -28,11 +28,10 @@ void FileHierarchy::ShowFileHierarchy(std::shared_ptr<Scene> scene, bool &showAd
         {
             auto Objects = scene->GetModels();
             // All other objects in the game
-            for (const auto& obj : Objects) {
-                if(ImGui::Selectable(obj->name.c_str())) {
+            for (const ObjectHandle obj : Objects) {
+                if(ImGui::Selectable(scene->GetObject(obj)->GetName().c_str())) {
                     scene->selectedGameObj = obj;
                     scene->selectedCamera = nullptr;
-                    scene->mOrL = true;
                 }
             }
             ImGui::TreePop(); // End of Root Folder
@@ -44,7 +43,7 @@ void FileHierarchy::ShowFileHierarchy(std::shared_ptr<Scene> scene, bool &showAd
             {
                 auto cam = Cameras[i];
                 if(ImGui::Selectable(std::string("Camera" + std::to_string(i)).c_str())) {
-                    scene->selectedGameObj = nullptr;
+                    scene->selectedGameObj = ObjectHandle{};
                     scene->selectedCamera = cam;
                     scene->SetCurrCameraIdx(i);
                 }
@@ -54,11 +53,10 @@ void FileHierarchy::ShowFileHierarchy(std::shared_ptr<Scene> scene, bool &showAd
         if (ImGui::TreeNode("Lights")) {
             auto Lights = scene->GetLights();
             // All other objects in the game
-            for (const auto& l : Lights) {
-                if(ImGui::Selectable(std::string("Light" + (std::to_string(l->id))).c_str())) {
+            for (const ObjectHandle l : Lights) {
+                if(ImGui::Selectable(std::string("Light" + (std::to_string(l.index))).c_str())) {
                     scene->selectedGameObj = l;
                     scene->selectedCamera = nullptr;
-                    scene->mOrL = false;
                 }
             }
             ImGui::TreePop();
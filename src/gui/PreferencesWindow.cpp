@@ -45,11 +45,46 @@ void PreferencesWindow::ShowPreferencesWindow(MainEngine* mainEngine)
             mainEngine->movementSense = movementSense / 100;
         }
 
-        glm::vec3 gravity = mainEngine->gravity;
+        glm::vec3 gravity = mainEngine->physics.gravity;
         ImGui::Text("Movement Sensitivity");
         ImGui::SameLine();
         if(ImGui::DragFloat3("##MovementSense", &gravity[0], 0.01f, 0.00001f, 0.0f, "%.2f")) {
-            mainEngine->gravity = gravity;
+            mainEngine->physics.gravity = gravity;
+        }
+
+        ImGui::EndTabItem();
+    }
+
+    if (ImGui::BeginTabItem("Simulation")) {
+
+        float stepRate = 1.0f / mainEngine->physics.fixedTimeStep;
+        ImGui::Text("Step Rate (Hz)");
+        ImGui::SameLine();
+        if(ImGui::DragFloat("##StepRate", &stepRate, 1.0f, 10.0f, 1000.0f, "%.0f", ImGuiSliderFlags_AlwaysClamp)) {
+            mainEngine->physics.fixedTimeStep = 1.0f / stepRate;
+        }
+
+        ImGui::Text("Substeps");
+        ImGui::SameLine();
+        ImGui::DragInt("##Substeps", &mainEngine->physics.substeps, 0.1f, 1, 64, "%d", ImGuiSliderFlags_AlwaysClamp);
+
+        ImGui::Text("Max Steps Per Frame");
+        ImGui::SameLine();
+        ImGui::DragInt("##MaxSteps", &mainEngine->physics.maxStepsPerFrame, 0.1f, 1, 16, "%d", ImGuiSliderFlags_AlwaysClamp);
+
+        static int threadCount = static_cast<int>(mainEngine->GetJobSystem().GetThreadCount());
+        ImGui::Text("Threads");
+        ImGui::SameLine();
+        ImGui::DragInt("##Threads", &threadCount, 0.1f, 1, 256, "%d", ImGuiSliderFlags_AlwaysClamp);
+        ImGui::SameLine();
+        if(ImGui::Button("Apply")) {
+            mainEngine->SetThreadCount(threadCount);
+        }
+
+        ImGui::Separator();
+        ImGui::Text("Soft Body Step Times");
+        for (const auto& stats : mainEngine->GetBodyStepStats()) {
+            ImGui::Text("%s: %.3f ms", stats.name.c_str(), stats.milliseconds);
         }
 
         ImGui::EndTabItem();
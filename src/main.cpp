@@ -8,7 +8,6 @@
 #include <fstream>
 #include <chrono>
 
-#define TINYOBJLOADER_IMPLEMENTATION
 #include "gui/gui_engine.h"
 #define GL_SILENCE_DEPRECATION
 #if defined(IMGUI_IMPL_OPENGL_ES2)
@@ -91,6 +90,13 @@ int main(int argc, char *argv[])
 	}
 
 	mainEngine = MainEngine();
+
+	// --threads N sizes the job system, --threads 1 runs every job inline for debugging
+	for (int i = 1; i + 1 < argc; ++i) {
+		if (std::string(argv[i]) == "--threads") {
+			mainEngine.SetThreadCount(std::stoul(argv[i + 1]));
+		}
+	}
 	guiEngine = std::make_unique<GuiEngine>();
 	renderEngine = std::make_unique<RenderEngine>(window, &mainEngine);
 
@@ -156,9 +162,12 @@ int main(int argc, char *argv[])
         start = end;
 
 		guiEngine->run();
+		renderEngine->UploadPendingModels();
 		if(guiEngine->showView) {
+			renderEngine->BeginFrame(guiEngine->SendViewportInfo());
 			renderEngine->MapShadows(depthMap, shadowWidth, shadowHeight);
 			renderEngine->Display(guiEngine->SendViewportInfo(), depthMap);
+			renderEngine->EndFrame();
 		}
 
         end = std::chrono::steady_clock::now();
@@ -199,6 +208,9 @@ int main(int argc, char *argv[])
 	}
 	guiEngine->cleanup();
 
+	// Frees its GL objects while the context still exists
+	renderEngine.reset();
+
     glfwDestroyWindow(window);
     glfwTerminate();
 
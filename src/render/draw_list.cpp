@@ -0,0 +1,54 @@
+#include "render/draw_list.h"
+
+#include <algorithm>
+
+void DrawList::Sort() {
+    const size_t count = items.size();
+    if (count < 2) return;
+
+    // Histograms of all eight 8 bit digits in one pass over the keys
+    size_t histograms[8][256] = {};
+    for (const DrawItem& item : items) {
+        for (int digit = 0; digit < 8; ++digit) {
+            ++histograms[digit][(item.key >> (digit * 8)) & 0xff];
+        }
+    }
+
+    scratch.resize(count);
+    DrawItem* src = items.data();
+    DrawItem* dst = scratch.data();
+
+    for (int digit = 0; digit < 8; ++digit) {
+        const int shift = digit * 8;
+        size_t* histogram = histograms[digit];
+
+        // Every key has the same digit (the pass and program bits usually
+        // do): the order would not change
+        if (histogram[(src[0].key >> shift) & 0xff] == count) continue;
+
+        size_t offset = 0;
+        for (int bucket = 0; bucket < 256; ++bucket) {
+            const size_t bucketCount = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += bucketCount;
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            dst[histogram[(src[i].key >> shift) & 0xff]++] = src[i];
+        }
+        std::swap(src, dst);
+    }
+
+    if (src != items.data()) items.swap(scratch);
+}
+
+std::pair<size_t, size_t> DrawList::PassRange(RenderPass pass) const {
+    // The pass is the top field of the key, so the items are sorted by it
+    auto begin = std::lower_bound(items.begin(), items.end(), pass, [](const DrawItem& item, RenderPass p) {
+        return DrawKey::PassOf(item.key) < p;
+    });
+    auto end = std::upper_bound(begin, items.end(), pass, [](RenderPass p, const DrawItem& item) {
+        return p < DrawKey::PassOf(item.key);
+    });
+    return {size_t(begin - items.begin()), size_t(end - items.begin())};
+}
@@ -0,0 +1,165 @@
+#include "render/frustum.h"
+
+#include "core/physics/simd_kernels.h"
+
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define RENDER_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#define RENDER_TARGET_AVX2
+#else
+#define RENDER_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#endif
+#endif
+
+Frustum Frustum::FromMatrix(const glm::mat4& clip) {
+    // Gribb & Hartmann: each plane is the 4th row of the matrix plus or minus
+    // one of the others. glm is column major, so row r is clip[c][r].
+    auto row = [&](int r) { return glm::vec4(clip[0][r], clip[1][r], clip[2][r], clip[3][r]); };
+
+    Frustum frustum;
+    frustum.planes[0] = row(3) + row(0);
+    frustum.planes[1] = row(3) - row(0);
+    frustum.planes[2] = row(3) + row(1);
+    frustum.planes[3] = row(3) - row(1);
+    frustum.planes[4] = row(3) + row(2);
+    frustum.planes[5] = row(3) - row(2);
+
+    // Normalised so the plane test is a distance (not needed for the sign,
+    // but keeps the extent term in the same units)
+    for (glm::vec4& plane : frustum.planes) {
+        const float length = glm::length(glm::vec3(plane));
+        if (length > 0.0f) plane = plane * (1.0f / length);
+    }
+    return frustum;
+}
+
+void AabbList::Clear() {
+    count = 0;
+    for (auto* array : {&cx, &cy, &cz, &ex, &ey, &ez}) array->clear();
+}
+
+void AabbList::Add(const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::mat4& model) {
+    const glm::vec3 center = 0.5f * (boundsMin + boundsMax);
+    const glm::vec3 extent = 0.5f * (boundsMax - boundsMin);
+
+    // Arvo: the world extent along each axis is |M| * local extent
+    const glm::vec3 worldCenter = glm::vec3(model * glm::vec4(center, 1.0f));
+    const glm::vec3 worldExtent = glm::abs(glm::vec3(model[0])) * extent.x
+                                + glm::abs(glm::vec3(model[1])) * extent.y
+                                + glm::abs(glm::vec3(model[2])) * extent.z;
+
+    // Replace the padding (or grow it by a full block)
+    if (count == cx.size()) {
+        for (auto* array : {&cx, &cy, &cz, &ex, &ey, &ez}) array->resize(count + kLanes, 0.0f);
+    }
+    cx[count] = worldCenter.x; cy[count] = worldCenter.y; cz[count] = worldCenter.z;
+    ex[count] = worldExtent.x; ey[count] = worldExtent.y; ez[count] = worldExtent.z;
+    ++count;
+}
+
+namespace {
+
+    // ---------------------------------------------------------------- scalar
+
+    void CullScalar(const Frustum& f, const AabbList& b, uint8_t* visible, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            bool inside = true;
+            for (const glm::vec4& p : f.planes) {
+                // Distance of the box corner furthest along the plane normal
+                const float d = p.x * b.cx[i] + p.y * b.cy[i] + p.z * b.cz[i] + p.w
+                              + std::abs(p.x) * b.ex[i] + std::abs(p.y) * b.ey[i] + std::abs(p.z) * b.ez[i];
+                inside = inside && d >= 0.0f;
+            }
+            visible[i] = inside ? 1 : 0;
+        }
+    }
+
+#ifdef RENDER_SIMD_X86
+
+    // ------------------------------------------------------------------ SSE2
+
+    void CullSSE2(const Frustum& f, const AabbList& b, uint8_t* visible, size_t n) {
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+
+        for (size_t i = 0; i < n; i += 4) {
+            const __m128 cx = _mm_loadu_ps(b.cx.data() + i);
+            const __m128 cy = _mm_loadu_ps(b.cy.data() + i);
+            const __m128 cz = _mm_loadu_ps(b.cz.data() + i);
+            const __m128 ex = _mm_loadu_ps(b.ex.data() + i);
+            const __m128 ey = _mm_loadu_ps(b.ey.data() + i);
+            const __m128 ez = _mm_loadu_ps(b.ez.data() + i);
+
+            __m128 outside = zero;
+            for (const glm::vec4& p : f.planes) {
+                const __m128 nx = _mm_set1_ps(p.x), ny = _mm_set1_ps(p.y), nz = _mm_set1_ps(p.z);
+                __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, cx), _mm_mul_ps(ny, cy)),
+                                      _mm_add_ps(_mm_mul_ps(nz, cz), _mm_set1_ps(p.w)));
+                d = _mm_add_ps(d, _mm_mul_ps(_mm_andnot_ps(signMask, nx), ex));
+                d = _mm_add_ps(d, _mm_mul_ps(_mm_andnot_ps(signMask, ny), ey));
+                d = _mm_add_ps(d, _mm_mul_ps(_mm_andnot_ps(signMask, nz), ez));
+                outside = _mm_or_ps(outside, _mm_cmplt_ps(d, zero));
+            }
+
+            const int mask = _mm_movemask_ps(outside);
+            for (size_t lane = 0; lane < 4 && i + lane < n; ++lane) {
+                visible[i + lane] = (mask >> lane) & 1 ? 0 : 1;
+            }
+        }
+    }
+
+    // ------------------------------------------------------------------ AVX2
+
+    RENDER_TARGET_AVX2
+    void CullAVX2(const Frustum& f, const AabbList& b, uint8_t* visible, size_t n) {
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 signMask = _mm256_set1_ps(-0.0f);
+
+        for (size_t i = 0; i < n; i += 8) {
+            const __m256 cx = _mm256_loadu_ps(b.cx.data() + i);
+            const __m256 cy = _mm256_loadu_ps(b.cy.data() + i);
+            const __m256 cz = _mm256_loadu_ps(b.cz.data() + i);
+            const __m256 ex = _mm256_loadu_ps(b.ex.data() + i);
+            const __m256 ey = _mm256_loadu_ps(b.ey.data() + i);
+            const __m256 ez = _mm256_loadu_ps(b.ez.data() + i);
+
+            __m256 outside = zero;
+            for (const glm::vec4& p : f.planes) {
+                const __m256 nx = _mm256_set1_ps(p.x), ny = _mm256_set1_ps(p.y), nz = _mm256_set1_ps(p.z);
+                __m256 d = _mm256_fmadd_ps(nx, cx, _mm256_set1_ps(p.w));
+                d = _mm256_fmadd_ps(ny, cy, d);
+                d = _mm256_fmadd_ps(nz, cz, d);
+                d = _mm256_fmadd_ps(_mm256_andnot_ps(signMask, nx), ex, d);
+                d = _mm256_fmadd_ps(_mm256_andnot_ps(signMask, ny), ey, d);
+                d = _mm256_fmadd_ps(_mm256_andnot_ps(signMask, nz), ez, d);
+                outside = _mm256_or_ps(outside, _mm256_cmp_ps(d, zero, _CMP_LT_OQ));
+            }
+
+            const int mask = _mm256_movemask_ps(outside);
+            for (size_t lane = 0; lane < 8 && i + lane < n; ++lane) {
+                visible[i + lane] = (mask >> lane) & 1 ? 0 : 1;
+            }
+        }
+    }
+
+#endif // RENDER_SIMD_X86
+
+}
+
+void CullAabbs(const Frustum& frustum, const AabbList& boxes, std::vector<uint8_t>& visible) {
+    const size_t n = boxes.Size();
+    visible.resize(n);
+    if (n == 0) return;
+
+    // The padded tail is read but never written back
+    switch (simd::ActiveSet()) {
+#ifdef RENDER_SIMD_X86
+        case simd::InstructionSet::AVX2: CullAVX2(frustum, boxes, visible.data(), n); return;
+        case simd::InstructionSet::SSE2: CullSSE2(frustum, boxes, visible.data(), n); return;
+#endif
+        default: CullScalar(frustum, boxes, visible.data(), n);
+    }
+}
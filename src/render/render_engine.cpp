@@ -1,149 +1,75 @@
 #include "render/render_engine.h"
 
-#include "render/tiny_obj_loader.h"
+#include "core/assets/asset_registry.h"
 #include "core/components/component.h"
 #include "core/components/light.h"
 #include "core/components/transform.h"
 
-#include <fmt/core.h>
+#include <algorithm>
+#include <array>
+#include <cstddef>
 
-void RenderEngine::Init()
-{
-	ShadersInit();
-}
+namespace {
+    // Instance matrices use attribute locations 3-6 (model) and 7-10
+    // (modelInverseTranspose), one vec4 column each
+    constexpr GLuint kInstanceAttrib = 3;
 
-void LoadOBJ(
-    const std::string &filename,
-    std::vector<glm::vec3> &outPositions,
-    std::vector<glm::vec3> &outNormals,
-    std::vector<glm::vec2> &outTexCoords,
-    std::vector<unsigned int> &outIndices) {
-    tinyobj::attrib_t attrib;
-    std::vector<tinyobj::shape_t> shapes;
-    std::vector<tinyobj::material_t> materials;
-    std::string err;
-
-    bool ret = tinyobj::LoadObj(&attrib, &shapes, &materials, &err,
-                                filename.c_str());
-
-    if (!err.empty())
-        std::cerr << "TinyOBJ error: " << err << std::endl;
-
-    if (!ret)
-        throw std::runtime_error("Failed to load OBJ: " + filename);
-
-    // Map unique vertex combination to index
-    struct Vertex {
-        int posIdx, normIdx, texIdx;
-
-        bool operator==(const Vertex &other) const {
-            return posIdx == other.posIdx &&
-                   normIdx == other.normIdx &&
-                   texIdx == other.texIdx;
-        }
-    };
+    // Used for models without a Material component
+    const Material kDefaultMaterial;
 
-    struct VertexHash {
-        size_t operator()(const Vertex &v) const {
-            return std::hash<int>()(v.posIdx) ^
-                   std::hash<int>()(v.normIdx << 1) ^
-                   std::hash<int>()(v.texIdx << 2);
-        }
-    };
-
-    std::unordered_map<Vertex, unsigned int, VertexHash> uniqueVertices;
-
-    // Loop through all shapes
-    for (const auto &shape: shapes) {
-        for (size_t f = 0; f < shape.mesh.indices.size(); ++f) {
-            tinyobj::index_t idx = shape.mesh.indices[f];
-
-            Vertex v{idx.vertex_index, idx.normal_index, idx.texcoord_index};
-
-            auto it = uniqueVertices.find(v);
-            if (it != uniqueVertices.end()) {
-                outIndices.push_back(it->second);
-            } else {
-                glm::vec3 pos(0.0f);
-                glm::vec3 norm(0.0f);
-                glm::vec2 tex(0.0f);
-
-                // Positions
-                if (v.posIdx >= 0) {
-                    pos.x = attrib.vertices[3 * v.posIdx + 0];
-                    pos.y = attrib.vertices[3 * v.posIdx + 1];
-                    pos.z = attrib.vertices[3 * v.posIdx + 2];
-                }
-
-                // Normals
-                if (v.normIdx >= 0) {
-                    norm.x = attrib.normals[3 * v.normIdx + 0];
-                    norm.y = attrib.normals[3 * v.normIdx + 1];
-                    norm.z = attrib.normals[3 * v.normIdx + 2];
-                }
-
-                // Texture coords
-                if (v.texIdx >= 0) {
-                    tex.x = attrib.texcoords[2 * v.texIdx + 0];
-                    tex.y = attrib.texcoords[2 * v.texIdx + 1];
-                }
-
-                unsigned int newIndex = static_cast<unsigned int>(outPositions.size());
-                outPositions.push_back(pos);
-                outNormals.push_back(norm);
-                outTexCoords.push_back(tex);
-                outIndices.push_back(newIndex);
-
-                uniqueVertices[v] = newIndex;
-            }
-        }
+    // Material values as one key; equal materials get the same draw key id
+    std::array<float, 10> MaterialKey(const Material* material) {
+        return {material->ambient.x, material->ambient.y, material->ambient.z,
+                material->diffuse.x, material->diffuse.y, material->diffuse.z,
+                material->specular.x, material->specular.y, material->specular.z,
+                material->shininess};
     }
-
-    std::cout << "Loaded OBJ: " << filename
-            << " (" << outPositions.size() << " vertices, "
-            << outIndices.size() / 3 << " triangles)\n";
 }
 
+void RenderEngine::Init()
+{
+	ShadersInit();
 
-void RenderEngine::LoadModel(const std::string &path) {
-    std::vector<glm::vec3> positions;
-    std::vector<glm::vec3> normals;
-    std::vector<glm::vec2> texcoords;
-    std::vector<unsigned int> indices;
+	glGenBuffers(1, &instanceVBO);
+}
 
-    LoadOBJ(path, positions, normals, texcoords, indices);
+void RenderEngine::UploadMesh(MeshHandle handle) {
+    // Shared with the soft bodies through the registry; uploaded straight
+    // from the mapped mesh cache, no intermediate copies
+    const MeshData& mesh = AssetRegistry::Instance().GetRenderMesh(handle);
+    const size_t vertexCount = mesh.GetVertexCount();
 
     GLuint posVBO, norVBO, texVBO, ebo, vao;
 
-    // Position VBO (dynamic for soft bodies)
+    // Position VBO (static; soft bodies draw from their own buffers)
     glGenBuffers(1, &posVBO);
     glBindBuffer(GL_ARRAY_BUFFER, posVBO);
     glBufferData(GL_ARRAY_BUFFER,
-                 positions.size() * sizeof(glm::vec3),
-                 positions.data(),
-                 GL_DYNAMIC_DRAW);
+                 vertexCount * sizeof(glm::vec3),
+                 mesh.GetPositions(),
+                 GL_STATIC_DRAW);
 
     // Normal VBO (static)
     glGenBuffers(1, &norVBO);
     glBindBuffer(GL_ARRAY_BUFFER, norVBO);
     glBufferData(GL_ARRAY_BUFFER,
-                 normals.size() * sizeof(glm::vec3),
-                 normals.data(),
+                 vertexCount * sizeof(glm::vec3),
+                 mesh.GetNormals(),
                  GL_STATIC_DRAW);
 
     // Texture coordinate VBO (static)
     glGenBuffers(1, &texVBO);
     glBindBuffer(GL_ARRAY_BUFFER, texVBO);
     glBufferData(GL_ARRAY_BUFFER,
-                 texcoords.size() * sizeof(glm::vec2),
-                 texcoords.data(),
+                 vertexCount * sizeof(glm::vec2),
+                 mesh.GetTexCoords(),
                  GL_STATIC_DRAW);
 
     glGenBuffers(1, &ebo);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-                 indices.size() * sizeof(unsigned int),
-                 indices.data(),
+                 mesh.GetIndexCount() * mesh.GetIndexSize(),
+                 mesh.GetIndexData(),
                  GL_STATIC_DRAW);
 
     // Create VAO
@@ -163,19 +89,78 @@ void RenderEngine::LoadModel(const std::string &path) {
     glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 0, nullptr); // texcoord at location 2
     glEnableVertexAttribArray(2);
 
+    // Per-instance matrices; BindInstances points them into the instance
+    // buffer for each draw group
+    for (GLuint i = 0; i < 8; ++i) {
+        glEnableVertexAttribArray(kInstanceAttrib + i);
+        glVertexAttribDivisor(kInstanceAttrib + i, 1);
+    }
+
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
 
     glBindVertexArray(0); // unbind VAO
 
-    // Store buffers & counts
-    posBuffMap[path] = posVBO;
-    norBuffMap[path] = norVBO;
-    texBuffMap[path] = texVBO;
-    indexBuffMap[path] = ebo;
-    vaoMap[path] = vao;
-    indexCountMap[path] = indices.size();
+    GpuMesh& gpuMesh = gpuMeshes[handle];
+    gpuMesh.vao = vao;
+    gpuMesh.posVBO = posVBO;
+    gpuMesh.norVBO = norVBO;
+    gpuMesh.texVBO = texVBO;
+    gpuMesh.ebo = ebo;
+    gpuMesh.indexCount = static_cast<GLsizei>(mesh.GetIndexCount());
+    gpuMesh.indexType = mesh.GetIndexSize() == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    gpuMesh.boundsMin = mesh.GetBoundsMin();
+    gpuMesh.boundsMax = mesh.GetBoundsMax();
 }
 
+const GpuMesh* RenderEngine::RequestModel(Model &model) {
+    // The only path lookup; every later frame indexes the table directly
+    if (model.mesh == kInvalidMesh) {
+        model.mesh = AssetRegistry::Instance().RequestMesh(model.GetModelPath(), mainEngine->GetJobSystem());
+    }
+
+    if (model.mesh >= gpuMeshes.size()) gpuMeshes.resize(model.mesh + 1);
+
+    GpuMesh& gpuMesh = gpuMeshes[model.mesh];
+    if (gpuMesh.IsUploaded()) return &gpuMesh;
+
+    if (!gpuMesh.requested) {
+        gpuMesh.requested = true;
+        pendingMeshes.push_back(model.mesh);
+    }
+    return nullptr;
+}
+
+void RenderEngine::UploadPendingModels() {
+    AssetRegistry& registry = AssetRegistry::Instance();
+    size_t uploadedBytes = 0;
+
+    for (auto it = pendingMeshes.begin(); it != pendingMeshes.end();) {
+        const MeshHandle handle = *it;
+        const AssetState state = registry.GetMeshState(handle);
+
+        // Stays marked as requested, so a broken file is not retried every frame
+        if (state == AssetState::Failed) {
+            it = pendingMeshes.erase(it);
+            continue;
+        }
+        if (state != AssetState::Ready) {
+            ++it;
+            continue;
+        }
+
+        const MeshData& mesh = registry.GetRenderMesh(handle);
+        const size_t bytes = mesh.GetVertexCount() * (2 * sizeof(glm::vec3) + sizeof(glm::vec2))
+                           + mesh.GetIndexCount() * mesh.GetIndexSize();
+
+        // The first upload of a frame always goes through so a mesh larger
+        // than the budget still gets on screen
+        if (uploadedBytes > 0 && uploadedBytes + bytes > uploadBudgetBytes) break;
+
+        UploadMesh(handle);
+        uploadedBytes += bytes;
+        it = pendingMeshes.erase(it);
+    }
+}
 
 // Function to generate a normal for a face (using the cross product of two edges)
 glm::vec3 RenderEngine::GenerateNormal(const std::vector<glm::vec3>& faceVertices)
@@ -208,161 +193,292 @@ void RenderEngine::ShadersInit()
 
     shadow.SetShadersFileName(shadersPath + verts[1],shadersPath + frags[1]);
     shadow.Init();
+
+    program.BindUniformBlock("FrameData", kFrameDataBinding);
+    shadow.BindUniformBlock("FrameData", kFrameDataBinding);
+
+    glGenBuffers(1, &frameUBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, frameUBO);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniforms), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, kFrameDataBinding, frameUBO);
+
+    phongLocations.ka = program.GetUniformLocation("ka");
+    phongLocations.kd = program.GetUniformLocation("kd");
+    phongLocations.ks = program.GetUniformLocation("ks");
+    phongLocations.s = program.GetUniformLocation("s");
+    phongLocations.shadowMap = program.GetUniformLocation("shadowMap");
 }
 
-void RenderEngine::MapShadows(GLuint depthMapFBO, GLuint const shadowWidth,  GLuint const shadowHeight)
+void RenderEngine::BeginFrame(glm::vec4 viewportInfo)
 {
-    glCullFace(GL_FRONT);
-    glUseProgram(shadow.GetPID());
-    glViewport(0, 0, shadowWidth, shadowHeight);
-    glBindFramebuffer(GL_FRAMEBUFFER, depthMapFBO);
-    glClear(GL_DEPTH_BUFFER_BIT);
-
-    shadow.Bind();
+    drawList.Clear();
+    instances.clear();
+    softBodyBuffers.BeginFrame();
 
     const auto& scene = mainEngine->GetCurrScene();
+    if (!scene) return;
 
-    glm::mat4 lightSpaceMatrix = scene->getLightSpaceMatrix();
-    shadow.SendUniformData(lightSpaceMatrix, "lightSpaceMatrix");
+    // Buffers are kept by entity, so drop them as soon as their body goes
+    // (or as soon as another scene's entities are drawn)
+    if (scene.get() != softBodyScene) {
+        softBodyBuffers.Clear();
+        softBodyScene = scene.get();
+    }
+    for (Entity entity : scene->GetRegistry().TakeRemovedSoftBodies()) {
+        softBodyBuffers.Release(entity);
+    }
 
-    for (const auto& model : scene->GetModels())
-    {
-        const auto& objTransform = std::dynamic_pointer_cast<Transform>( model->components[TRANSFORM]);
-        const auto& objModel = std::dynamic_pointer_cast<Model>(model->components[MODEL]);
+    frameUniforms = FrameUniforms{};
 
+    camera = scene->GetCurrCamera();
+    if (camera) {
+        camera->SetAspect(viewportInfo.z, viewportInfo.w);
+        frameUniforms.view = camera->GetViewMatrix();
+        frameUniforms.projection = camera->GetProjectionMatrix();
+    }
 
-        if (!objTransform || !objModel) continue; // essential components must exist
+    scene->UpdateTransforms();
 
-        std::string& modelPath = objModel->modelPath;
+    frameUniforms.lightSpaceMatrix = scene->getLightSpaceMatrix();
+    frameUniforms.lightPosition = scene->getlightEye();
 
-        // Check if the position buffer is already loaded
-        if (posBuffMap.find(modelPath) == posBuffMap.end()) {
-            // Load model buffers if they are not already loaded
-            LoadModel(modelPath);
-        }
+    // Lights past kMaxLights are not shaded
+    int lightCount = 0;
+    scene->GetRegistry().Each<Transform, PointLight>([&](Entity, const Transform& transform, const PointLight& light) {
+        if (lightCount == kMaxLights) return;
 
-        glm::mat4 modelMatrix(1.0f);
-        modelMatrix = glm::translate(glm::mat4(1.0f), objTransform->position)
-            * glm::rotate(glm::mat4(1.0f), glm::radians(objTransform->rotation[0]), glm::vec3(1.0f, 0.0f, 0.0f))
-            * glm::rotate(glm::mat4(1.0f), glm::radians(objTransform->rotation[1]), glm::vec3(0.0f, 1.0f, 0.0f))
-            * glm::rotate(glm::mat4(1.0f), glm::radians(objTransform->rotation[2]), glm::vec3(0.0f, 0.0f, 1.0f))
-            * glm::scale(glm::mat4(1.0f), objTransform->scale);
+        frameUniforms.lights[lightCount].position = glm::vec3(transform.GetWorldMatrix()[3]);
+        frameUniforms.lights[lightCount].color = light.color;
+        ++lightCount;
+    });
 
-        shadow.SendAttributeData(posBuffMap[modelPath], "aPos", 3);
+    glBindBuffer(GL_UNIFORM_BUFFER, frameUBO);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameUniforms), &frameUniforms);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
 
-        shadow.SendUniformData(modelMatrix, "model");
+    // Culls with the matrices above
+    BuildDrawList(*scene);
+}
+
+void RenderEngine::BuildDrawList(Scene& scene)
+{
+    objectInstances.clear();
+    objectEntities.clear();
+    objectSoftBodies.clear();
+    objectDraws.clear();
+    objectBounds.Clear();
+    frameMaterials.clear();
+    materialIds.clear();
+
+    uint32_t softBodyCount = 0;
+
+    ComponentRegistry& registry = scene.GetRegistry();
+    const ComponentPool<Material>& materials = registry.Pool<Material>();
+    const ComponentPool<SoftBody>& softBodies = registry.Pool<SoftBody>();
+
+    registry.Each<Transform, Model>([&](Entity entity, Transform& transform, Model& modelComp) {
+        // Not uploaded yet: skip it until the background load is done
+        const GpuMesh* mesh = RequestModel(modelComp);
+        if (!mesh) return;
+
+        const Material* material = materials.Get(entity);
+        const SoftBody* softBody = softBodies.Get(entity);
+
+        glm::mat4 modelMatrix = transform.GetModelMatrix(mesh->bias);
+        // The bias is a translation, which leaves the normal matrix alone
+        objectInstances.push_back({modelMatrix, transform.GetWorldInverseTranspose()});
+        objectEntities.push_back(entity);
+        objectSoftBodies.push_back(softBody);
+
+        // A soft body has moved away from the mesh's rest shape
+        if (softBody) {
+            objectBounds.Add(softBody->boundsMin, softBody->boundsMax, modelMatrix);
+        } else {
+            objectBounds.Add(mesh->boundsMin, mesh->boundsMax, modelMatrix);
+        }
 
-        glDrawArrays(GL_TRIANGLES, 0, posBuffMap[modelPath] / 3);
+        // Objects with equal material values share a material id, so a batch
+        // can span them
+        const Material* objMaterial = material ? material : &kDefaultMaterial;
+        auto [it, inserted] = materialIds.try_emplace(MaterialKey(objMaterial),
+                                                      static_cast<uint32_t>(frameMaterials.size()));
+        if (inserted) frameMaterials.push_back(objMaterial);
+
+        // A soft body draws its own positions, so it is never batched with
+        // rigid objects. Past kMaxUnique soft bodies share values; Draw
+        // splits those runs.
+        const uint32_t unique = softBody ? softBodyCount++ % DrawKey::kMaxUnique + 1 : 0;
+
+        objectDraws.push_back({modelComp.mesh, it->second, unique});
+    });
+
+    // The shadow pass draws what the light's ortho box contains, the main
+    // pass what the camera sees
+    CullAabbs(Frustum::FromMatrix(frameUniforms.lightSpaceMatrix), objectBounds, visibleToLight);
+    if (camera) {
+        CullAabbs(Frustum::FromMatrix(frameUniforms.projection * frameUniforms.view), objectBounds, visibleToCamera);
+    } else {
+        visibleToCamera.assign(objectBounds.Size(), 0);
     }
 
-    shadow.Unbind();
+    drawList.Reserve(2 * objectDraws.size());
+    objectPositions.assign(objectDraws.size(), SoftBodyBuffers::Binding{});
 
-    glCullFace(GL_BACK);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-}
+    for (size_t i = 0; i < objectDraws.size(); ++i) {
+        const ObjectDraw& draw = objectDraws[i];
+        const auto object = static_cast<uint32_t>(i);
 
-void RenderEngine::Display(glm::vec4 viewportInfo, GLuint depthMap)
-{
-    // TODO
-    // Fix code so that all faces are rendered properly
-    // Right now only top and bottom face are being simulated since theres only 8 vertices being updated in code
+        // Only drawn soft bodies are uploaded, and only if they moved
+        if (objectSoftBodies[i] && (visibleToLight[i] || visibleToCamera[i])) {
+            objectPositions[i] = softBodyBuffers.Update(objectEntities[i], *objectSoftBodies[i]);
+        }
 
-    int width, height;
-    glfwGetWindowSize(window, &width, &height);
+        if (visibleToLight[i]) {
+            drawList.Add(DrawKey::Make(RenderPass::Shadow, kShadowProgram, draw.mesh, 0, draw.unique), object);
+        }
+        if (visibleToCamera[i]) {
+            drawList.Add(DrawKey::Make(RenderPass::Main, kPhongProgram, draw.mesh, draw.material, draw.unique), object);
+        }
+    }
 
-    glUseProgram(program.GetPID());
-    glViewport(viewportInfo.x, height - viewportInfo.w - viewportInfo.y,
-               viewportInfo.z, viewportInfo.w);
+    drawList.Sort();
 
-    glEnable(GL_DEPTH_TEST);
+    const auto& items = drawList.GetItems();
+    instances.resize(items.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+        instances[i] = objectInstances[items[i].object];
+    }
 
-    const auto& scene = mainEngine->GetCurrScene();
-    if (!scene) return;
+    // Orphan the buffer so the driver doesn't wait for last frame's draws
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    instanceCapacity = std::max(instanceCapacity, instances.size());
+    glBufferData(GL_ARRAY_BUFFER, instanceCapacity * sizeof(InstanceData), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, instances.size() * sizeof(InstanceData), instances.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
 
-    camera = scene->GetCurrCamera();
-    if (!camera) return;
+struct RenderEngine::DrawBackend {
+    RenderEngine& engine;
+    uint32_t program = UINT32_MAX;
+    const GpuMesh* mesh = nullptr;
 
-    camera->SetAspect(viewportInfo.z, viewportInfo.w);
+    void BindProgram(uint32_t id) {
+        program = id;
+        (id == kShadowProgram ? engine.shadow : engine.program).Bind();
+    }
 
-    glm::mat4 projection = camera->GetProjectionMatrix();
-    glm::mat4 view = camera->GetViewMatrix();
+    void BindMesh(uint32_t handle) {
+        mesh = &engine.gpuMeshes[handle];
+        glBindVertexArray(mesh->vao);
+    }
 
-    glm::vec3 lightPosition = scene->getlightEye();
-    glm::mat4 lightSpaceMatrix = scene->getLightSpaceMatrix();
+    void BindMaterial(uint32_t id) {
+        if (program != kPhongProgram) return;
 
-    // Render each model
-    for (const auto &model: scene->GetModels()) {
-        auto transform = std::dynamic_pointer_cast<Transform>(model->components[TRANSFORM]);
-        auto material = std::dynamic_pointer_cast<Material>(model->components[MATERIAL]);
-        auto modelComp = std::dynamic_pointer_cast<Model>(model->components[MODEL]);
-        auto softBody = std::dynamic_pointer_cast<SoftBody>(model->components[SOFTBODY]);
+        const Material* material = engine.frameMaterials[id];
+        const auto& locations = engine.phongLocations;
+        engine.program.SendUniformData(material->ambient, locations.ka);
+        engine.program.SendUniformData(material->diffuse, locations.kd);
+        engine.program.SendUniformData(material->specular, locations.ks);
+        engine.program.SendUniformData(material->shininess, locations.s);
+    }
 
-        if (!transform || !modelComp) continue;
+    void Draw(size_t first, size_t count) {
+        // A soft body reads its positions from its own buffer (in the mesh's
+        // vertex layout); point location 0 there for this draw only
+        const uint32_t object = engine.drawList.GetItems()[first].object;
+        const SoftBodyBuffers::Binding& positions = engine.objectPositions[object];
+        if (positions.buffer && count > 1) {
+            for (size_t i = 0; i < count; ++i) Draw(first + i, 1);
+            return;
+        }
+        if (positions.buffer) {
+            glBindBuffer(GL_ARRAY_BUFFER, positions.buffer);
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, reinterpret_cast<const void*>(positions.offset));
+        }
 
-        const std::string &path = modelComp->modelPath;
+        engine.BindInstances(static_cast<GLint>(first));
+        glDrawElementsInstanced(GL_TRIANGLES, mesh->indexCount, mesh->indexType, 0,
+                                static_cast<GLsizei>(count));
 
-        if (vaoMap.find(path) == vaoMap.end())
-            LoadModel(path);
+        if (positions.buffer) {
+            glBindBuffer(GL_ARRAY_BUFFER, mesh->posVBO);
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+        }
+    }
+};
 
-        GLuint vao = vaoMap[path];
-        GLuint posVBO = posBuffMap[path];
-        size_t count = indexCountMap[path];
+void RenderEngine::BindInstances(GLint firstInstance)
+{
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+
+    const size_t base = firstInstance * sizeof(InstanceData);
+    for (GLuint column = 0; column < 4; ++column) {
+        const size_t columnOffset = column * sizeof(glm::vec4);
+        glVertexAttribPointer(kInstanceAttrib + column, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+            reinterpret_cast<const void*>(base + offsetof(InstanceData, model) + columnOffset));
+        glVertexAttribPointer(kInstanceAttrib + 4 + column, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+            reinterpret_cast<const void*>(base + offsetof(InstanceData, modelInverseTranspose) + columnOffset));
+    }
+}
 
+void RenderEngine::EndFrame()
+{
+    softBodyBuffers.EndFrame();
+}
 
-        glBindVertexArray(vao);
-        glBindBuffer(GL_ARRAY_BUFFER, posVBO);
+void RenderEngine::MapShadows(GLuint depthMapFBO, GLuint const shadowWidth,  GLuint const shadowHeight)
+{
+    glCullFace(GL_FRONT);
+    glUseProgram(shadow.GetPID());
+    glViewport(0, 0, shadowWidth, shadowHeight);
+    glBindFramebuffer(GL_FRAMEBUFFER, depthMapFBO);
+    glClear(GL_DEPTH_BUFFER_BIT);
 
-        // Update soft-body positions
-        if (softBody) {
-            glBufferSubData(GL_ARRAY_BUFFER, 0,
-                            softBody->positions.size() * sizeof(glm::vec3),
-                            softBody->positions.data());
-        }
+    shadow.Bind();
 
-        glm::mat4 modelMatrix = transform->GetModelMatrix(biasMap[path]);
-        glm::mat4 normalMatrix = glm::transpose(glm::inverse(modelMatrix));
+    DrawBackend backend{*this};
+    drawList.Submit(RenderPass::Shadow, backend);
 
-        program.Bind();
+    glBindVertexArray(0);
+    shadow.Unbind();
 
-        program.SendUniformData(modelMatrix, "model");
-        program.SendUniformData(view, "view");
-        program.SendUniformData(projection, "projection");
-        program.SendUniformData(normalMatrix, "modelInverseTranspose");
+    glCullFace(GL_BACK);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
 
-        program.SendUniformData(lightSpaceMatrix, "lightSpaceMatrix");
-        program.SendUniformData(lightPosition, "lightPosition");
+void RenderEngine::Display(glm::vec4 viewportInfo, GLuint depthMap)
+{
+    int width, height;
+    glfwGetWindowSize(window, &width, &height);
 
-        // Shadow map
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, depthMap);
-        program.SendUniformData(0, "shadowMap");
+    glUseProgram(program.GetPID());
+    glViewport(viewportInfo.x, height - viewportInfo.w - viewportInfo.y,
+               viewportInfo.z, viewportInfo.w);
 
-        // Material
-        if (material) {
-            program.SendUniformData(material->ambient, "ka");
-            program.SendUniformData(material->diffuse, "kd");
-            program.SendUniformData(material->specular, "ks");
-            program.SendUniformData(material->shininess, "s");
-        }
+    glEnable(GL_DEPTH_TEST);
+
+    const auto& scene = mainEngine->GetCurrScene();
+    if (!scene) return;
 
-        // Lights
-        const auto &lights = scene->GetLights();
-        for (size_t i = 0; i < lights.size(); ++i) {
-            auto lTransform = std::dynamic_pointer_cast<Transform>(lights[i]->components[TRANSFORM]);
-            auto lComp = std::dynamic_pointer_cast<PointLight>(lights[i]->components[LIGHT]);
-            if (!lTransform || !lComp) continue;
+    camera = scene->GetCurrCamera();
+    if (!camera) return;
 
-            std::string base = fmt::format("lights[{}]", i);
-            program.SendUniformData(lTransform->position, (base + ".position").c_str());
-            program.SendUniformData(lComp->color, (base + ".color").c_str());
-        }
+    program.Bind();
 
-        // Draw
-        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(count), GL_UNSIGNED_INT, 0);
-        glBindVertexArray(0);
+    // Shadow map
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, depthMap);
+    program.SendUniformData(0, phongLocations.shadowMap);
 
-        program.Unbind();
-    }
+    // Camera, lights and instance matrices were uploaded by BeginFrame;
+    // the draw list only rebinds what changes between batches
+    DrawBackend backend{*this};
+    drawList.Submit(RenderPass::Main, backend);
+
+    glBindVertexArray(0);
+    program.Unbind();
 }
 
 void RenderEngine::CharacterCallback(GLFWwindow *window, unsigned int key) {
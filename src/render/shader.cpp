@@ -2,6 +2,7 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <algorithm>
 
 Shader::Shader() : programID(0) {}
 
@@ -84,6 +85,58 @@ void Shader::Init()
     // Cleanup shaders after linking
     glDeleteShader(vertShader);
     glDeleteShader(fragShader);
+
+    CacheUniformLocations();
+}
+
+void Shader::CacheUniformLocations()
+{
+    uniformLocations.clear();
+
+    GLint count = 0, maxLength = 0;
+    glGetProgramiv(programID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(programID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+    std::vector<char> nameBuffer(std::max(maxLength, 1));
+    for (GLint i = 0; i < count; ++i) {
+        GLint size;
+        GLenum type;
+        GLsizei length;
+        glGetActiveUniform(programID, i, static_cast<GLsizei>(nameBuffer.size()), &length, &size, &type, nameBuffer.data());
+        std::string name(nameBuffer.data(), length);
+
+        // Block members have no location; they are set through the buffer
+        const GLint location = glGetUniformLocation(programID, name.c_str());
+        if (location == -1) continue;
+        uniformLocations[name] = location;
+
+        // Arrays are reported as "name[0]"; also accept "name" and every element
+        const size_t bracket = name.size() - 3;
+        if (name.size() > 3 && name.compare(bracket, 3, "[0]") == 0) {
+            const std::string base = name.substr(0, bracket);
+            uniformLocations[base] = location;
+            for (GLint element = 1; element < size; ++element) {
+                const std::string elementName = base + "[" + std::to_string(element) + "]";
+                uniformLocations[elementName] = glGetUniformLocation(programID, elementName.c_str());
+            }
+        }
+    }
+}
+
+GLint Shader::GetUniformLocation(const char* name) const
+{
+    auto it = uniformLocations.find(name);
+    return it == uniformLocations.end() ? -1 : it->second;
+}
+
+void Shader::BindUniformBlock(const char* name, GLuint binding)
+{
+    GLuint index = glGetUniformBlockIndex(programID, name);
+    if (index == GL_INVALID_INDEX) {
+        std::cerr << "Uniform block " << name << " not found in shader program." << std::endl;
+        return;
+    }
+    glUniformBlockBinding(programID, index, binding);
 }
 
 std::string Shader::ReadShader(const std::string &name)
@@ -154,22 +207,42 @@ void Shader::SendAttributeData(GLuint bufferID, const char* name, GLint size)
 
 void Shader::SendUniformData(int input, const char* name)
 {
-    glUniform1i(glGetUniformLocation(programID, name), input);
+    SendUniformData(input, GetUniformLocation(name));
 }
 
 void Shader::SendUniformData(float input, const char* name)
 {
-    glUniform1f(glGetUniformLocation(programID, name), input);
+    SendUniformData(input, GetUniformLocation(name));
 }
 
 void Shader::SendUniformData(glm::vec3 input, const char* name)
 {
-    glUniform3f(glGetUniformLocation(programID, name), input.x, input.y, input.z);
+    SendUniformData(input, GetUniformLocation(name));
 }
 
 void Shader::SendUniformData(glm::mat4 &input, const char* name)
 {
-    glUniformMatrix4fv(glGetUniformLocation(programID, name), 1, GL_FALSE, &input[0][0]);
+    SendUniformData(input, GetUniformLocation(name));
+}
+
+void Shader::SendUniformData(int input, GLint location)
+{
+    glUniform1i(location, input);
+}
+
+void Shader::SendUniformData(float input, GLint location)
+{
+    glUniform1f(location, input);
+}
+
+void Shader::SendUniformData(glm::vec3 input, GLint location)
+{
+    glUniform3f(location, input.x, input.y, input.z);
+}
+
+void Shader::SendUniformData(const glm::mat4 &input, GLint location)
+{
+    glUniformMatrix4fv(location, 1, GL_FALSE, &input[0][0]);
 }
 
 void Shader::Bind()
@@ -0,0 +1,118 @@
+#include "render/soft_body_buffers.h"
+
+#include "core/components/softbody.h"
+
+#include <cstring>
+
+namespace {
+    // Buffers of bodies not drawn for this many frames (culled ones) are freed
+    constexpr uint64_t kUnusedFrames = 120;
+
+    // Slot offsets stay aligned for any vertex attribute
+    constexpr size_t kSlotAlignment = 256;
+}
+
+SoftBodyBuffers::SoftBodyBuffers() {
+    persistent = GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_buffer_storage;
+}
+
+SoftBodyBuffers::~SoftBodyBuffers() {
+    Clear();
+    for (GLsync& fence : fences) {
+        if (fence) glDeleteSync(fence);
+    }
+}
+
+void SoftBodyBuffers::Release(Entity entity) {
+    const auto it = entries.find(entity);
+    if (it == entries.end()) return;
+
+    Release(it->second);
+    entries.erase(it);
+}
+
+void SoftBodyBuffers::Clear() {
+    for (auto& [entity, entry] : entries) Release(entry);
+    entries.clear();
+}
+
+void SoftBodyBuffers::Release(Entry& entry) {
+    if (entry.mapped) {
+        glBindBuffer(GL_ARRAY_BUFFER, entry.buffer);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    glDeleteBuffers(1, &entry.buffer);
+    entry = Entry{};
+}
+
+void SoftBodyBuffers::BeginFrame() {
+    ++frame;
+
+    // The slots written this frame were last read at most kFrames frames ago
+    GLsync& fence = fences[frame % kFrames];
+    if (fence) {
+        glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (frame - it->second.lastUsedFrame > kUnusedFrames) {
+            Release(it->second);
+            it = entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+SoftBodyBuffers::Binding SoftBodyBuffers::Update(Entity entity, const SoftBody& body) {
+    const size_t bytes = body.positions.size() * sizeof(glm::vec3);
+    const size_t slotBytes = (bytes + kSlotAlignment - 1) / kSlotAlignment * kSlotAlignment;
+
+    Entry& entry = entries[entity];
+    entry.lastUsedFrame = frame;
+
+    // Not moved since the last upload: keep drawing the slot it is in
+    if (entry.buffer && entry.version == body.positionsVersion && entry.slotBytes == slotBytes) {
+        return {entry.buffer, static_cast<GLintptr>(entry.slot * entry.slotBytes)};
+    }
+
+    if (entry.slotBytes != slotBytes) {
+        if (entry.buffer) Release(entry);
+        entry.lastUsedFrame = frame;
+        entry.slotBytes = slotBytes;
+
+        glGenBuffers(1, &entry.buffer);
+        glBindBuffer(GL_ARRAY_BUFFER, entry.buffer);
+        if (persistent) {
+            // Dynamic storage too, so glBufferSubData still works if mapping fails
+            const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            glBufferStorage(GL_ARRAY_BUFFER, slotBytes * kFrames, nullptr, flags | GL_DYNAMIC_STORAGE_BIT);
+            entry.mapped = glMapBufferRange(GL_ARRAY_BUFFER, 0, slotBytes * kFrames, flags);
+        } else {
+            glBufferData(GL_ARRAY_BUFFER, slotBytes * kFrames, nullptr, GL_STREAM_DRAW);
+        }
+    } else {
+        entry.slot = (entry.slot + 1) % kFrames;
+        glBindBuffer(GL_ARRAY_BUFFER, entry.buffer);
+    }
+
+    const size_t offset = entry.slot * slotBytes;
+    if (entry.mapped) {
+        std::memcpy(static_cast<char*>(entry.mapped) + offset, body.positions.data(), bytes);
+    } else {
+        glBufferSubData(GL_ARRAY_BUFFER, offset, bytes, body.positions.data());
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    entry.version = body.positionsVersion;
+    return {entry.buffer, static_cast<GLintptr>(offset)};
+}
+
+void SoftBodyBuffers::EndFrame() {
+    GLsync& fence = fences[frame % kFrames];
+    if (fence) glDeleteSync(fence);
+    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
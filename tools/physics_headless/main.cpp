@@ -0,0 +1,167 @@
+// Windowless soft body runner for batch jobs.
+//
+//   physics_headless [scene file] [--frames N] [--rate Hz] [--substeps N] [--threads N]
+//
+// Loads the scene, runs N fixed steps through the same PhysicsSystem the
+// editor uses, as fast as the machine allows, and prints the step rate.
+//
+// Scene files are plain text, one entry per line, '#' starts a comment:
+//   softbody <model.obj> [x y z]   soft body object
+//   model    <model.obj> [x y z]   static object, not simulated
+//   gravity  <x y z>
+// Model names are resolved against resources/models like in the editor.
+
+#include "core/physics_system.h"
+#include "core/job_system.h"
+#include "core/scene.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+namespace {
+    bool LoadScene(const std::string& path, Scene& scene, PhysicsSystem& physics) {
+        std::ifstream file(path);
+        if (!file) {
+            std::cerr << "Could not open scene file " << path << std::endl;
+            return false;
+        }
+
+        std::string line;
+        int lineNumber = 0;
+        while (std::getline(file, line)) {
+            ++lineNumber;
+            line = line.substr(0, line.find('#'));
+
+            std::istringstream in(line);
+            std::string kind;
+            if (!(in >> kind)) continue;
+
+            if (kind == "gravity") {
+                glm::vec3 gravity;
+                if (!(in >> gravity.x >> gravity.y >> gravity.z)) {
+                    std::cerr << path << ":" << lineNumber << ": gravity needs x y z" << std::endl;
+                    return false;
+                }
+                physics.gravity = gravity;
+                continue;
+            }
+
+            if (kind != "softbody" && kind != "model") {
+                std::cerr << path << ":" << lineNumber << ": unknown entry '" << kind << "'" << std::endl;
+                return false;
+            }
+
+            std::string objFile;
+            if (!(in >> objFile)) {
+                std::cerr << path << ":" << lineNumber << ": " << kind << " needs a model file" << std::endl;
+                return false;
+            }
+
+            glm::vec3 position(0.0f);
+            in >> position.x >> position.y >> position.z;
+
+            GameObject* obj = scene.GetObject(scene.AddModel(objFile, ""));
+            obj->GetTransform()->SetPosition(position);
+
+            if (kind == "softbody") {
+                obj->AddComponent(SOFTBODY);
+            }
+        }
+
+        return true;
+    }
+
+    // Same soft cube the editor drops in its default scene
+    void MakeDefaultScene(Scene& scene) {
+        GameObject* obj = scene.GetObject(scene.AddModel("cube.obj", "cube"));
+        obj->GetTransform()->SetPosition({0.0f, 10.0f, 0.0f});
+        obj->AddComponent(SOFTBODY);
+    }
+
+    void PrintUsage() {
+        std::cerr << "usage: physics_headless [scene file] [--frames N] [--rate Hz] [--substeps N] [--threads N]" << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string scenePath;
+    int frames = 600;
+    float rate = 60.0f;
+    int substeps = PhysicsSystem().substeps;
+    size_t threadCount = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "--frames" && hasValue) {
+            frames = std::stoi(argv[++i]);
+        }
+        else if (arg == "--rate" && hasValue) {
+            rate = std::stof(argv[++i]);
+        }
+        else if (arg == "--substeps" && hasValue) {
+            substeps = std::stoi(argv[++i]);
+        }
+        else if (arg == "--threads" && hasValue) {
+            threadCount = std::stoul(argv[++i]);
+        }
+        else if (arg == "--help" || arg == "-h") {
+            PrintUsage();
+            return 0;
+        }
+        else if (!arg.empty() && arg[0] != '-' && scenePath.empty()) {
+            scenePath = arg;
+        }
+        else {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    if (frames <= 0 || rate <= 0.0f || substeps <= 0) {
+        std::cerr << "--frames, --rate and --substeps must be positive" << std::endl;
+        return 1;
+    }
+
+    PhysicsSystem physics;
+    physics.fixedTimeStep = 1.0f / rate;
+    physics.substeps = substeps;
+
+    Scene scene;
+    if (scenePath.empty()) {
+        MakeDefaultScene(scene);
+    }
+    else if (!LoadScene(scenePath, scene, physics)) {
+        return 1;
+    }
+
+    JobSystem jobs(threadCount);
+
+    const auto start = std::chrono::steady_clock::now();
+    physics.Step(scene, jobs, frames);
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    size_t particleCount = 0;
+    size_t constraintCount = 0;
+    for (const SoftBody& body : scene.GetRegistry().Pool<SoftBody>().Components()) {
+        particleCount += body.particles.Size();
+        constraintCount += body.topology->constraints.size();
+    }
+
+    const double seconds = elapsed.count();
+    std::cout << "bodies:      " << physics.GetBodyStepStats().size() << std::endl;
+    std::cout << "particles:   " << particleCount << std::endl;
+    std::cout << "constraints: " << constraintCount << std::endl;
+    std::cout << "threads:     " << jobs.GetThreadCount() << std::endl;
+    std::cout << "steps:       " << frames << " x " << substeps << " substeps" << std::endl;
+    std::cout << "wall time:   " << seconds << " s" << std::endl;
+    std::cout << "steps/sec:   " << frames / seconds << std::endl;
+    std::cout << "realtime:    " << (frames * physics.fixedTimeStep) / seconds << "x" << std::endl;
+
+    return 0;
+}